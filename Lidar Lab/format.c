@@ -0,0 +1,108 @@
+// Formatting Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Output is written through putcUart0
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "uart0.h"
+#include "format.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static const uint32_t powersOf10[10] =
+{
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Number of decimal digits in value (at least 1)
+static uint8_t countDigits(uint32_t value)
+{
+    uint8_t digits = 1;
+    while (digits < 10 && value >= powersOf10[digits])
+        digits++;
+    return digits;
+}
+
+// Writes exactly digits decimal digits of value, most significant first
+static void putDigits(uint32_t value, uint8_t digits)
+{
+    uint32_t power;
+    uint8_t d;
+    while (digits > 0)
+    {
+        power = powersOf10[--digits];
+        d = value / power;
+        value -= d * power;
+        putcUart0('0' + d);
+    }
+}
+
+// Writes an unsigned value right aligned in width characters, like "%*lu"
+void putDecUart0(uint32_t value, uint8_t width)
+{
+    uint8_t digits = countDigits(value);
+    while (width-- > digits)
+        putcUart0(' ');
+    putDigits(value, digits);
+}
+
+// Writes a signed value right aligned in width characters, like "%*ld"
+void putIntUart0(int32_t value, uint8_t width)
+{
+    uint32_t magnitude = (value < 0) ? 0 - (uint32_t)value : (uint32_t)value;
+    uint8_t digits = countDigits(magnitude) + (value < 0);
+    while (width-- > digits)
+        putcUart0(' ');
+    if (value < 0)
+        putcUart0('-');
+    putDigits(magnitude, digits - (value < 0));
+}
+
+// Writes the low digits nibbles of value as zero padded upper case hex
+void putHexUart0(uint32_t value, uint8_t digits)
+{
+    uint8_t nibble;
+    while (digits > 0)
+    {
+        nibble = (value >> (--digits * 4)) & 15;
+        putcUart0(nibble < 10 ? '0' + nibble : 'A' - 10 + nibble);
+    }
+}
+
+// Writes a fixed-point value scaled by 10^fractionDigits, e.g. (-12345, 2) prints -123.45
+void putFixedUart0(int32_t value, uint8_t fractionDigits)
+{
+    uint32_t magnitude = (value < 0) ? 0 - (uint32_t)value : (uint32_t)value;
+    uint32_t scale;
+
+    if (fractionDigits > 9)
+        fractionDigits = 9;
+    scale = powersOf10[fractionDigits];
+    if (value < 0)
+        putcUart0('-');
+    putDigits(magnitude / scale, countDigits(magnitude / scale));
+    if (fractionDigits > 0)
+    {
+        putcUart0('.');
+        putDigits(magnitude % scale, fractionDigits);
+    }
+}
@@ -3,7 +3,6 @@
  */
 
 #include <stdint.h>
-#include <stdio.h>
 #include <stdbool.h>
 
 #include "wait.h"
@@ -12,18 +11,30 @@
 #include "tm4c123gh6pm.h"
 #include "gpio.h"
 #include "nvic.h"
+#include "udma.h"
+#include "uart1.h"
+#include "rplidar.h"
+#include "format.h"
+#include "telemetry.h"
+#include "command.h"
 
 // PortA masks PA7 for PWM  (M1PWM3)
 // 1b
 #define PWM_MASK 128
 #define PWM_MOTOR PWM1_1_CMPB_R
 
-// Pins
-#define UART_TX_1 PORTB,1
-#define UART_RX_1 PORTB,0
+// Angle bins batched into one binary telemetry record
+#define LIDAR_TELEMETRY_POINTS 32
+
+// Time allowed for the response descriptor after a scan request, and between retries
+#define DESCRIPTOR_TIMEOUT_MS 100
+#define SCAN_RETRY_MS 1000
 
 uint32_t pwmVal = 1023;
 
+// Express scan streams capsules at the full sample rate, false selects the standard scan
+bool expressScan = true;
+
 void initPWM(){
     // Enable clocks
     SYSCTL_RCGCPWM_R |= SYSCTL_RCGCPWM_R1;
@@ -49,36 +60,6 @@ void initPWM(){
     PWM1_ENABLE_R = PWM_ENABLE_PWM3EN;
 }
 
-// Initialize UART1
-void initUart1(void){
-    // Enable clocks
-    SYSCTL_RCGCUART_R |= SYSCTL_RCGCUART_R1;
-    _delay_cycles(3);
-
-    // Configure UART0 pins
-    selectPinPushPullOutput(UART_TX_1);
-    selectPinDigitalInput(UART_RX_1);
-    setPinAuxFunction(UART_TX_1, GPIO_PCTL_PB1_U1TX);
-    setPinAuxFunction(UART_RX_1, GPIO_PCTL_PB0_U1RX);
-
-    // Configure UART1 with default baud rate
-    UART1_CTL_R = 0;                                    // turn-off UART0 to allow safe programming
-    UART1_CC_R = UART_CC_CS_SYSCLK;                     // use system clock (usually 40 MHz)
-}
-
-// Set baud rate as function of instruction cycle frequency
-void setUart1BaudRate(uint32_t baudRate, uint32_t fcyc){
-    uint32_t divisorTimes128 = (fcyc * 8) / baudRate;   // calculate divisor (r) in units of 1/128,
-                                                        // where r = fcyc / 16 * baudRate
-    divisorTimes128 += 1;                               // add 1/128 to allow rounding
-    UART1_CTL_R = 0;                                    // turn-off UART0 to allow safe programming
-    UART1_IBRD_R = divisorTimes128 >> 7;                // set integer value to floor(r)
-    UART1_FBRD_R = ((divisorTimes128) >> 1) & 63;       // set fractional value to round(fract(r)*64)
-    UART1_LCRH_R = UART_LCRH_WLEN_8 | UART_LCRH_FEN;    // configure for 8N1 w/ 16-level FIFO
-    UART1_CTL_R = UART_CTL_TXE | UART_CTL_RXE | UART_CTL_UARTEN;
-                                                        // turn-on UART1
-}
-
 // Initialize Hardware
 void initHw(){
     // Initialize system clock to 40 MHz
@@ -89,54 +70,16 @@ void initHw(){
     initUart0();
     setUart0BaudRate(115200, 40e6);
 
+    initUdma();
     initUart1();
     setUart1BaudRate(115200, 40e6);
 
 }
 
-// Blocking function that writes a serial character when the UART buffer is not full
-void putcUart1(uint8_t c){
-    while (UART1_FR_R & UART_FR_TXFF);               // wait if uart1 tx fifo full
-    UART1_DR_R = c;                                  // write character to fifo
-}
-
-// Blocking function that writes a string when the UART buffer is not full
-void putsUart1(char *str){
-    uint8_t i = 0;
-    while (str[i] != '\0')
-        putcUart0(str[i++]);
-}
-
-// Blocking function that returns with serial data once the buffer is not empty
-uint8_t getcUart1(void){
-    while (UART1_FR_R & UART_FR_RXFE);               // wait if uart0 rx fifo empty
-    return UART1_DR_R & 0xFF;                        // get character from fifo
-}
-
-// Returns the status of the receive buffer
-bool kbhitUart1(void){
-    return !(UART1_FR_R & UART_FR_RXFE);
-}
-
-
 void itoa_h(uint32_t num){
-    char table[16] = {'0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'};
-    char buff[9];
-    uint32_t indx = 0;
-    uint8_t offset = 28;
-    uint8_t i;
-    for( i = 0; i < 8; i++){
-        indx = (num & (0xF << offset));
-        indx = indx >> offset;
-        buff[i] = table[indx];
-        offset -= 4;
-    }
-    buff[8] = '\0';
-
     putsUart0("0x");
-    putsUart0(buff);
+    putHexUart0(num, 8);
     putsUart0("\n");
-
 }
 void getInfo(){
     putcUart1(0xA5);
@@ -146,79 +89,179 @@ void getScanned(){
     putcUart1(0xA5);
     putcUart1(0x20);
 }
+// Express scan request: A5 82, payload size, working mode 0 + 4 reserved bytes, xor checksum
+void getExpressScanned(){
+    uint8_t request[8] = {0xA5, 0x82, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00};
+    uint8_t checksum = 0;
+    uint8_t i;
+    for (i = 0; i < 8; i++){
+        checksum ^= request[i];
+        putcUart1(request[i]);
+    }
+    putcUart1(checksum);
+}
 void stopCommand(){
     putcUart1(0xA5);
     putcUart1(0x25);
     waitMicrosecond(2000);
 }
-typedef struct _dataRecieved{
-    uint8_t quality;
-    uint8_t angle_lower;
-    uint8_t angle_upper;
-    uint8_t distance_lower;
-    uint8_t distance_upper;
+// Read the response descriptor of the scan just requested, false on a timeout, a bad
+// A5 5A header or a data type that does not match the requested mode
+bool readScanDescriptor(){
+    uint8_t descriptor[RPLIDAR_DESCRIPTOR_SIZE];
+    uint8_t count = 0;
+    uint16_t waited = 0;
+    while (count < RPLIDAR_DESCRIPTOR_SIZE){
+        if (kbhitUart1()){
+            descriptor[count++] = getcUart1();
+        }
+        else if (waited++ < DESCRIPTOR_TIMEOUT_MS){
+            waitMicrosecond(1000);
+        }
+        else{
+            return false;
+        }
+    }
+    return descriptor[0] == RPLIDAR_DESCRIPTOR_SYNC1 && descriptor[1] == RPLIDAR_DESCRIPTOR_SYNC2
+        && descriptor[6] == (expressScan ? RPLIDAR_TYPE_EXPRESS_SCAN : RPLIDAR_TYPE_SCAN);
+}
+// Stop any running scan, drop what it left in the receive fifo and request a new one
+// until its descriptor checks out, so the decoders only ever see a known stream
+void startScan(){
+    while (1){
+        stopCommand();
+        while (kbhitUart1()){
+            getcUart1();
+        }
+        if (expressScan){
+            getExpressScanned();
+        }
+        else{
+            getScanned();
+        }
+        if (readScanDescriptor()){
+            return;
+        }
+        putsUart0("No valid scan response descriptor, retrying\n");
+        waitMicrosecond(SCAN_RETRY_MS * 1000);
+    }
+}
+// Revolution banks, filled by the decoders from uart1Isr
+RPLIDAR_SCAN scan;
+
+// Decode each byte of a completed receive half as it is handed over by uart1Isr
+void scanBytesReceived(uint8_t buffer[], uint16_t length){
+    uint16_t i;
+    for (i = 0; i < length; i++){
+        if (expressScan){
+            parseRplidarExpressByte(buffer[i], &scan);
+        }
+        else{
+            parseRplidarScanByte(buffer[i], &scan);
+        }
+    }
+}
+
+// Console commands, dispatched through the hashed table in command.c
+void binaryCommand(const COMMAND_ARGS *args){
+    setTelemetryMode(TELEMETRY_BINARY);
+}
 
-}dataRecieved;
+void textCommand(const COMMAND_ARGS *args){
+    setTelemetryMode(TELEMETRY_TEXT);
+}
 
-dataRecieved received[400];
+const COMMAND commands[] =
+{
+    {"binary", 0, "", binaryCommand},
+    {"text", 0, "", textCommand}
+};
+
+void processCommand(USER_DATA *data){
+    COMMAND_STATUS status = runCommand(data);
+    if (getTelemetryMode() == TELEMETRY_TEXT){
+        putCommandStatusUart0(status);
+    }
+}
 
 int main(void){
     initHw();
     initPWM();
-    char str[30];
-    uint32_t i, j;
-    j = 0;
-    uint16_t angleInt = 0;
-    uint16_t distanceInt = 0;
-    float angle = 0.0;
-    float distance = 0.0;
-    uint8_t descriptor[7];
-    uint8_t data[2000];
-
-
-    for (i = 0; i < 2000; i++){
-        data[i] = 0;
+    uint32_t i;
+    const uint16_t *bins = 0;
+    uint16_t printed = 0;
+    uint32_t droppedCount = 0;
+    uint16_t record[1 + LIDAR_TELEMETRY_POINTS];
+    uint16_t count;
+    USER_DATA data;
+
+    initTelemetry();
+    startUart0LineInput();
+    if (!initCommands(commands, sizeof(commands) / sizeof(commands[0]))){
+        putsUart0("Command table init failed\n");
     }
 
-    stopCommand();
-    getScanned();
+    // Response descriptor is sent once, scan nodes then stream until stopped
+    startScan();
+    resetRplidarParser();
+    startUart1RxDma(scanBytesReceived);
 
     while(1){
-        j = 0;
-
-        for (i = 0; i < 7; i++){
-            descriptor[i] = getcUart1();
+        if (getUart0Line(&data)){
+            processCommand(&data);
         }
-
-        for (i = 0; i < 2000; i++){
-            data[i] = getcUart1();
+        // Hold a completed revolution until it is sent, the decoders fill the other bank
+        if (bins == 0){
+            bins = getRplidarRevolution(&scan);
+            if (bins == 0){
+                continue;
+            }
+            printed = 0;
+            // Revolutions completed while the previous one was still being sent
+            if (scan.droppedCount != droppedCount){
+                droppedCount = scan.droppedCount;
+                if (getTelemetryMode() == TELEMETRY_TEXT){
+                    putsUart0("Dropped: ");
+                    putDecUart0(droppedCount, 0);
+                    putsUart0(" revolutions\n");
+                }
+                sendTelemetry(TELEMETRY_LIDAR_DROPPED, TELEMETRY_U32, &droppedCount, 1);
+            }
+            if (getTelemetryMode() == TELEMETRY_TEXT){
+                putcUart0('\n');
+            }
         }
 
-        putcUart0('\n');
-
         PWM1_1_CMPB_R = 0;
-        i = 0;
-
-        while (i < 2000){
-            received[j].quality = data[i++] ;
-            received[j].angle_lower = data[i++];
-            received[j].angle_upper = data[i++];
-            received[j].distance_lower = data[i++];
-            received[j].distance_upper = data[i++];
-
-            angleInt = (((received[j].angle_upper << 8) | (received[j].angle_lower)) >> 1);
-            angle = angleInt / 64.0;
-
-            distanceInt = ((received[j].distance_upper << 8) | (received[j].distance_lower));
-            distance = distanceInt / 4.0;
-
-            sprintf(str, "Angle: %.4f\n", angle);
-            putsUart1(str);
-            sprintf(str, "Distance: %.4f\n", distance);
-            putsUart1(str);
-            j++;
+
+        if (getTelemetryMode() == TELEMETRY_BINARY){
+            // First bin of the batch, then the distance Q2 of each bin
+            count = RPLIDAR_SCAN_BINS - printed;
+            if (count > LIDAR_TELEMETRY_POINTS){
+                count = LIDAR_TELEMETRY_POINTS;
+            }
+            record[0] = printed;
+            for (i = 0; i < count; i++){
+                record[1 + i] = bins[printed + i];
+            }
+            sendTelemetry(TELEMETRY_LIDAR_SCAN, TELEMETRY_U16, record, 1 + count);
+            printed += count;
+        }
+        else{
+            // Bins without a return are skipped, Q2 to 4 decimal places: x * 10000 / 4
+            if (bins[printed] != 0){
+                putsUart0("Angle: ");
+                putDecUart0(printed, 0);
+                putsUart0("\nDistance: ");
+                putFixedUart0(bins[printed] * 2500, 4);
+                putsUart0("\n");
+            }
+            printed++;
         }
-        putcUart0('\n');
 
+        if (printed >= RPLIDAR_SCAN_BINS){
+            releaseRplidarRevolution(&scan);
+            bins = 0;
+        }
     }
 }
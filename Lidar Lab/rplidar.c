@@ -0,0 +1,312 @@
+// RPLIDAR Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// RPLIDAR A1 on UART1 at 115200 baud, 8N1
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rplidar.h"
+
+/*
+ * Standard scan node
+ *  byte 0 : quality[7:2] | !S[1] | S[0]     S = start of a new revolution
+ *  byte 1 : angle_q6[6:0] << 1 | C[0]       C = check bit, always 1
+ *  byte 2 : angle_q6[14:7]
+ *  byte 3 : distance_q2[7:0]
+ *  byte 4 : distance_q2[15:8]
+ */
+#define START_BITS_M 3
+#define CHECK_BIT    1
+#define MAX_ANGLE_Q6 (360 * 64)
+
+/*
+ * Express scan capsule
+ *  byte 0     : 0xA << 4 | checksum[3:0]
+ *  byte 1     : 0x5 << 4 | checksum[7:4]     checksum = xor of bytes 2-83
+ *  byte 2-3   : S[15] | start_angle_q6[14:0]  S = first capsule after a (re)start
+ *  byte 4-83  : 16 cabins of 5 bytes
+ *      byte 0-1 : distance1_q2[15:2] | dtheta1_q3[5:4]
+ *      byte 2-3 : distance2_q2[15:2] | dtheta2_q3[5:4]
+ *      byte 4   : dtheta2_q3[3:0] << 4 | dtheta1_q3[3:0]
+ * The 32 measurements of a capsule are spread evenly between its start angle and
+ * the start angle of the following capsule, so each capsule is decoded one late
+ */
+#define SYNC1        0xA0
+#define SYNC2        0x50
+#define SYNC_M       0xF0
+#define EXP_START    0x8000
+#define CABIN_SIZE   5
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static uint8_t nodeBytes[RPLIDAR_NODE_SIZE];
+static uint8_t nodeCount = 0;
+static uint32_t resyncCount = 0;
+static bool revolutionStarted = false;              // a start flag has been seen since reset
+
+static uint8_t capsules[2][RPLIDAR_CAPSULE_SIZE];    // previous and in-progress capsule
+static uint8_t capsuleCurrent = 0;
+static uint8_t capsuleCount = 0;
+static bool capsulePreviousValid = false;
+static uint32_t checksumErrorCount = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// S and !S must differ
+static bool isNodeFirstByte(uint8_t c)
+{
+    uint8_t s = c & START_BITS_M;
+    return (s == 1) || (s == 2);
+}
+
+// Publish the filled bank if the reader is done with the last one, then clear the bank to fill
+static void startRevolution(RPLIDAR_SCAN *scan)
+{
+    uint16_t *bins;
+    uint16_t i;
+
+    if (revolutionStarted)
+    {
+        if (scan->ready)
+            scan->droppedCount++;
+        else
+        {
+            scan->filling ^= 1;
+            scan->ready = true;
+            scan->revolution++;
+        }
+    }
+    revolutionStarted = true;
+
+    bins = scan->distanceQ2[scan->filling];
+    for (i = 0; i < RPLIDAR_SCAN_BINS; i++)
+        bins[i] = 0;
+}
+
+// Keep the closest valid return in the bin of the measurement, starting a new revolution
+// on the start flag
+static void storePoint(RPLIDAR_SCAN *scan, uint16_t angleQ6, uint16_t distanceQ2, bool start)
+{
+    uint16_t *bin;
+
+    if (start)
+        startRevolution(scan);
+    if (!revolutionStarted || distanceQ2 == 0)
+        return;
+    bin = &scan->distanceQ2[scan->filling][angleQ6 >> 6];
+    if (*bin == 0 || distanceQ2 < *bin)
+        *bin = distanceQ2;
+}
+
+// Discard the partial node, e.g. after restarting a scan
+void resetRplidarParser(void)
+{
+    nodeCount = 0;
+    capsuleCount = 0;
+    capsulePreviousValid = false;
+    revolutionStarted = false;
+}
+
+/*
+ * Feed one received byte to the scan decoder
+ * Returns true and stores the measurement in scan when the byte completes a valid node
+ * A byte that breaks the node framing restarts the search at the next candidate
+ * first byte, so the decoder locks back on within a few bytes after a loss
+ */
+bool parseRplidarScanByte(uint8_t c, RPLIDAR_SCAN *scan)
+{
+    uint16_t angle;
+
+    nodeBytes[nodeCount++] = c;
+
+    if (nodeCount == 1)
+    {
+        if (!isNodeFirstByte(c))
+        {
+            nodeCount = 0;
+            resyncCount++;
+        }
+        return false;
+    }
+
+    if (nodeCount == 2)
+    {
+        if (!(c & CHECK_BIT))
+        {
+            // drop the bad first byte and try this one as a first byte instead
+            resyncCount++;
+            nodeBytes[0] = c;
+            nodeCount = isNodeFirstByte(c) ? 1 : 0;
+        }
+        return false;
+    }
+
+    if (nodeCount < RPLIDAR_NODE_SIZE)
+        return false;
+
+    nodeCount = 0;
+    angle = ((nodeBytes[2] << 8) | nodeBytes[1]) >> 1;
+    if (angle >= MAX_ANGLE_Q6)
+    {
+        resyncCount++;
+        return false;
+    }
+
+    storePoint(scan, angle, (nodeBytes[4] << 8) | nodeBytes[3], nodeBytes[0] & 1);
+    return true;
+}
+
+// Returns the number of bytes discarded to regain node alignment
+uint32_t getRplidarResyncCount(void)
+{
+    return resyncCount;
+}
+
+// Spread the cabins of the previous capsule across the angle up to the current capsule
+static void decodeCapsule(uint8_t prev[], uint8_t curr[], RPLIDAR_SCAN *scan)
+{
+    int32_t prevStartQ8 = (((prev[3] << 8) | prev[2]) & ~EXP_START) << 2;
+    int32_t currStartQ8 = (((curr[3] << 8) | curr[2]) & ~EXP_START) << 2;
+    int32_t diffQ8 = currStartQ8 - prevStartQ8;
+    int32_t incQ16;
+    int32_t angleQ16;
+    int32_t angleQ6;
+    uint16_t distanceAngle;
+    uint16_t distanceQ2;
+    uint8_t offsets;
+    uint8_t offsetQ3;
+    uint8_t *cabin;
+    uint8_t i;
+
+    if (prevStartQ8 > currStartQ8)
+        diffQ8 += 360 << 8;                          // wrapped through 0 degrees
+    incQ16 = diffQ8 << 3;                            // diff / 32 measurements, in 1/65536 degree
+    angleQ16 = prevStartQ8 << 8;
+
+    for (i = 0; i < RPLIDAR_CAPSULE_NODES; i++)
+    {
+        cabin = &prev[4 + (i >> 1) * CABIN_SIZE];
+        offsets = cabin[4];
+        if (i & 1)
+        {
+            distanceAngle = (cabin[3] << 8) | cabin[2];
+            offsetQ3 = (offsets >> 4) | ((distanceAngle & 3) << 4);
+        }
+        else
+        {
+            distanceAngle = (cabin[1] << 8) | cabin[0];
+            offsetQ3 = (offsets & 15) | ((distanceAngle & 3) << 4);
+        }
+
+        angleQ6 = (angleQ16 - ((int32_t)offsetQ3 << 13)) >> 10;
+        if (angleQ6 < 0)
+            angleQ6 += MAX_ANGLE_Q6;
+        if (angleQ6 >= MAX_ANGLE_Q6)
+            angleQ6 -= MAX_ANGLE_Q6;
+
+        distanceQ2 = distanceAngle & 0xFFFC;
+        storePoint(scan, angleQ6, distanceQ2, ((angleQ16 + incQ16) % (360L << 16)) < incQ16);
+        angleQ16 += incQ16;
+    }
+}
+
+/*
+ * Feed one received byte to the express scan decoder
+ * Returns the number of measurements stored in scan, RPLIDAR_CAPSULE_NODES each
+ * time a capsule completes (after the first), otherwise 0
+ * A byte that breaks the capsule framing restarts the search at the next candidate
+ * sync byte, and a capsule failing its checksum is discarded
+ */
+uint8_t parseRplidarExpressByte(uint8_t c, RPLIDAR_SCAN *scan)
+{
+    uint8_t *capsule = capsules[capsuleCurrent];
+    uint8_t checksum = 0;
+    uint8_t decoded = 0;
+    uint8_t i;
+
+    capsule[capsuleCount++] = c;
+
+    if (capsuleCount == 1)
+    {
+        if ((c & SYNC_M) != SYNC1)
+        {
+            capsuleCount = 0;
+            resyncCount++;
+        }
+        return 0;
+    }
+
+    if (capsuleCount == 2)
+    {
+        if ((c & SYNC_M) != SYNC2)
+        {
+            // drop the bad first byte and try this one as a first byte instead
+            resyncCount++;
+            capsule[0] = c;
+            capsuleCount = ((c & SYNC_M) == SYNC1) ? 1 : 0;
+        }
+        return 0;
+    }
+
+    if (capsuleCount < RPLIDAR_CAPSULE_SIZE)
+        return 0;
+
+    capsuleCount = 0;
+    for (i = 2; i < RPLIDAR_CAPSULE_SIZE; i++)
+        checksum ^= capsule[i];
+    if (checksum != ((capsule[0] & 15) | ((capsule[1] & 15) << 4)))
+    {
+        checksumErrorCount++;
+        capsulePreviousValid = false;                // angle spacing is unknown across a gap
+        return 0;
+    }
+
+    if (capsule[3] & (EXP_START >> 8))
+        capsulePreviousValid = false;                // scan restarted
+    else if (capsulePreviousValid)
+    {
+        decodeCapsule(capsules[capsuleCurrent ^ 1], capsule, scan);
+        decoded = RPLIDAR_CAPSULE_NODES;
+    }
+
+    capsulePreviousValid = true;
+    capsuleCurrent ^= 1;
+    return decoded;
+}
+
+// Returns the number of express capsules discarded for a bad checksum
+uint32_t getRplidarChecksumErrorCount(void)
+{
+    return checksumErrorCount;
+}
+
+// Returns the bins of the last completed revolution, or 0 if none is waiting
+// The bins stay valid and unchanged until releaseRplidarRevolution is called
+const uint16_t *getRplidarRevolution(RPLIDAR_SCAN *scan)
+{
+    if (!scan->ready)
+        return 0;
+    return scan->distanceQ2[scan->filling ^ 1];
+}
+
+// Hand the completed bank back so the next revolution can be published into it
+void releaseRplidarRevolution(RPLIDAR_SCAN *scan)
+{
+    scan->ready = false;
+}
@@ -0,0 +1,66 @@
+// RPLIDAR Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// RPLIDAR A1 on UART1 at 115200 baud, 8N1
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef RPLIDAR_H_
+#define RPLIDAR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Bytes in one standard scan measurement node
+#define RPLIDAR_NODE_SIZE 5
+
+// Bytes in one express scan capsule and measurements decoded from it
+#define RPLIDAR_CAPSULE_SIZE 84
+#define RPLIDAR_CAPSULE_NODES 32
+
+// Response descriptor sent before the scan data: A5 5A, length and mode, then data type
+#define RPLIDAR_DESCRIPTOR_SIZE 7
+#define RPLIDAR_DESCRIPTOR_SYNC1 0xA5
+#define RPLIDAR_DESCRIPTOR_SYNC2 0x5A
+#define RPLIDAR_TYPE_SCAN 0x81
+#define RPLIDAR_TYPE_EXPRESS_SCAN 0x82
+
+// One degree angle bins per revolution, the bin of a measurement is its angle q6 >> 6
+#define RPLIDAR_SCAN_BINS 360
+
+// Decoded revolutions, distance in 1/4 mm of the closest return in each bin (0 = none)
+// The decoders fill one bank while the other holds the last completed revolution
+// At each start flag the filled bank is published, unless the reader still holds the
+// previous one, in which case the revolution is dropped and its bank refilled
+typedef struct _RPLIDAR_SCAN
+{
+    uint16_t distanceQ2[2][RPLIDAR_SCAN_BINS];
+    uint8_t filling;                                 // bank written by the decoders
+    volatile bool ready;                             // other bank holds an unread revolution
+    volatile uint16_t revolution;                    // revolutions published
+    volatile uint32_t droppedCount;                  // revolutions dropped while one was held
+} RPLIDAR_SCAN;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void resetRplidarParser(void);
+bool parseRplidarScanByte(uint8_t c, RPLIDAR_SCAN *scan);
+uint32_t getRplidarResyncCount(void);
+uint8_t parseRplidarExpressByte(uint8_t c, RPLIDAR_SCAN *scan);
+uint32_t getRplidarChecksumErrorCount(void);
+const uint16_t *getRplidarRevolution(RPLIDAR_SCAN *scan);
+void releaseRplidarRevolution(RPLIDAR_SCAN *scan);
+
+#endif
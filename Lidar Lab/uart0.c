@@ -31,6 +31,20 @@
 // Global variables
 //-----------------------------------------------------------------------------
 
+// Transmit queue, written by putcUart0 and drained by uart0Isr
+static volatile char txBuffer[UART0_TX_BUFFER_SIZE];
+static volatile uint16_t txWriteIndex = 0;
+static volatile uint16_t txReadIndex = 0;
+static UART0_TX_POLICY txPolicy = UART0_TX_BLOCK;
+static uint32_t txQueuedCount = 0;
+static uint32_t txDroppedCount = 0;
+
+// Command line, edited by uart0Isr once line input is started and handed over by rxLineReady
+static char rxLine[MAX_CHARS + 1];
+static uint8_t rxCount = 0;
+static volatile bool rxLineReady = false;
+static uint32_t rxDroppedCount = 0;
+
 
 //-----------------------------------------------------------------------------
 // Subroutines
@@ -245,6 +259,16 @@ void initUart0(void)
     // Configure UART0 with default baud rate
     UART0_CTL_R = 0;                                    // turn-off UART0 to allow safe programming
     UART0_CC_R = UART_CC_CS_SYSCLK;                     // use system clock (usually 40 MHz)
+
+    // Configure transmit queue and interrupt
+    txWriteIndex = txReadIndex = 0;
+    txQueuedCount = txDroppedCount = 0;
+    txPolicy = UART0_TX_BLOCK;
+    rxCount = 0;
+    rxLineReady = false;
+    UART0_IFLS_R = UART_IFLS_RX1_8 | UART_IFLS_TX1_8;   // interrupt when rx fifo fills or tx fifo drains to 1/8
+    UART0_IM_R = 0;                                     // tx interrupt is unmasked only while data is queued
+    NVIC_EN0_R = 1 << (INT_UART0-16);                   // turn-on interrupt 21 (UART0)
 }
 
 // Set baud rate as function of instruction cycle frequency
@@ -261,14 +285,52 @@ void setUart0BaudRate(uint32_t baudRate, uint32_t fcyc)
                                                         // turn-on UART0
 }
 
-// Blocking function that writes a serial character when the UART buffer is not full
+// Moves queued characters into the tx fifo until the queue is empty or the fifo is full
+static void fillUart0TxFifo()
+{
+    while ((txReadIndex != txWriteIndex) && !(UART0_FR_R & UART_FR_TXFF))
+    {
+        UART0_DR_R = txBuffer[txReadIndex];
+        txReadIndex = (txReadIndex + 1) & (UART0_TX_BUFFER_SIZE - 1);
+    }
+}
+
+// Non-blocking function that queues a serial character for the UART0 interrupt to send
+// When the queue is full, the character is handled according to the tx policy
 void putcUart0(char c)
 {
-    while (UART0_FR_R & UART_FR_TXFF);               // wait if uart0 tx fifo full
-    UART0_DR_R = c;                                  // write character to fifo
+    uint16_t next;
+
+    UART0_IM_R &= ~UART_IM_TXIM;                     // hold off uart0Isr while the queue is modified
+    next = (txWriteIndex + 1) & (UART0_TX_BUFFER_SIZE - 1);
+    if (next == txReadIndex)
+    {
+        if (txPolicy == UART0_TX_BLOCK)
+        {
+            while (next == txReadIndex)
+                fillUart0TxFifo();                   // drain by polling, so this is safe inside an isr
+        }
+        else if (txPolicy == UART0_TX_DROP_OLDEST)
+        {
+            txReadIndex = (txReadIndex + 1) & (UART0_TX_BUFFER_SIZE - 1);
+            txDroppedCount++;
+        }
+        else
+        {
+            txDroppedCount++;
+            UART0_IM_R |= UART_IM_TXIM;
+            return;
+        }
+    }
+    txBuffer[txWriteIndex] = c;
+    txWriteIndex = next;
+    txQueuedCount++;
+    fillUart0TxFifo();                               // start transmission if the fifo has room
+    if (txReadIndex != txWriteIndex)
+        UART0_IM_R |= UART_IM_TXIM;                  // let uart0Isr send the rest as the fifo drains
 }
 
-// Blocking function that writes a string when the UART buffer is not full
+// Non-blocking function that queues a string for the UART0 interrupt to send
 void putsUart0(char* str)
 {
     uint8_t i = 0;
@@ -277,6 +339,7 @@ void putsUart0(char* str)
 }
 
 // Blocking function that returns with serial data once the buffer is not empty
+// Received characters go to the line editor instead once startUart0LineInput is called
 char getcUart0(void)
 {
     while (UART0_FR_R & UART_FR_RXFE);               // wait if uart0 rx fifo empty
@@ -288,3 +351,117 @@ bool kbhitUart0(void)
 {
     return !(UART0_FR_R & UART_FR_RXFE);
 }
+
+// Selects how putcUart0 handles a full transmit queue
+void setUart0TxPolicy(UART0_TX_POLICY policy)
+{
+    txPolicy = policy;
+}
+
+// Returns the number of characters accepted into the transmit queue
+uint32_t getUart0TxQueuedCount(void)
+{
+    return txQueuedCount;
+}
+
+// Returns the number of characters discarded because the transmit queue was full
+uint32_t getUart0TxDroppedCount(void)
+{
+    return txDroppedCount;
+}
+
+// Blocking function that returns once all queued characters have left the UART
+void flushUart0(void)
+{
+    while (txReadIndex != txWriteIndex);             // wait for uart0Isr to empty the queue
+    while (UART0_FR_R & UART_FR_BUSY);               // wait for the last character to shift out
+}
+
+// Line editor run by uart0Isr for each received character, same keys as getsUart0
+// Characters arriving before the main loop takes the previous line are dropped
+static void editUart0Line(char c)
+{
+    if (rxLineReady)
+    {
+        rxDroppedCount++;
+    }
+    else if (c == 8 || c == 127)                     // backspace or delete
+    {
+        if (rxCount > 0)
+            rxCount--;
+    }
+    else if (c == 13 || c == 10)                     // enter, empty lines (e.g. the lf of cr-lf) are ignored
+    {
+        if (rxCount > 0)
+        {
+            rxLine[rxCount] = '\0';
+            rxLineReady = true;
+        }
+    }
+    else if (c >= 32)                                // space or any printable char
+    {
+        rxLine[rxCount++] = c;
+        if (rxCount == MAX_CHARS)
+        {
+            rxLine[rxCount] = '\0';
+            rxLineReady = true;
+        }
+    }
+}
+
+// Assemble command lines in the background from the rx interrupt
+void startUart0LineInput(void)
+{
+    rxCount = 0;
+    rxLineReady = false;
+    UART0_ICR_R = UART_ICR_RXIC | UART_ICR_RTIC;
+    UART0_IM_R |= UART_IM_RXIM | UART_IM_RTIM;       // rx timeout delivers characters that do not fill the fifo
+}
+
+// Returns true once enter has been pressed on a line that has not been taken yet
+bool isUart0LineReady(void)
+{
+    return rxLineReady;
+}
+
+// Non-blocking replacement for getsUart0 and parseFields
+// Returns false if no line is ready, otherwise copies and parses it and starts the next one
+bool getUart0Line(USER_DATA *data)
+{
+    uint8_t i = 0;
+
+    if (!rxLineReady)
+        return false;
+    do
+    {
+        data->buffer[i] = rxLine[i];
+    } while (rxLine[i++] != '\0');
+    rxCount = 0;
+    rxLineReady = false;                             // hand the line back to uart0Isr
+    parseFields(data);
+    return true;
+}
+
+// Returns the number of characters received while a completed line was waiting
+uint32_t getUart0RxDroppedCount(void)
+{
+    return rxDroppedCount;
+}
+
+// UART0 interrupt service routine feeding the line editor and refilling the tx fifo
+void uart0Isr(void)
+{
+    if (UART0_MIS_R & (UART_MIS_RXMIS | UART_MIS_RTMIS))
+    {
+        UART0_ICR_R = UART_ICR_RXIC | UART_ICR_RTIC; // clear interrupt flags
+        while (!(UART0_FR_R & UART_FR_RXFE))
+            editUart0Line(UART0_DR_R & 0xFF);
+    }
+    if (UART0_MIS_R & UART_MIS_TXMIS)
+    {
+        UART0_ICR_R = UART_ICR_TXIC;                 // clear interrupt flag
+        fillUart0TxFifo();
+        if (txReadIndex == txWriteIndex)
+            UART0_IM_R &= ~UART_IM_TXIM;             // nothing left to send
+    }
+}
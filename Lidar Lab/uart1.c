@@ -0,0 +1,164 @@
+// UART1 Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// UART Interface:
+//   U1TX (PB1) and U1RX (PB0) are connected to the RPLIDAR
+// uDMA:
+//   Channel 22 (encoding 0) moves received bytes into two ping-pong buffers
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "uart1.h"
+#include "udma.h"
+#include "gpio.h"
+#include "nvic.h"
+
+// Pins
+#define UART_TX_1 PORTB,1
+#define UART_RX_1 PORTB,0
+
+// uDMA channel for UART1 RX
+#define RX_DMA_CHANNEL 22
+#define RX_DMA_ENCODING 0
+
+// Peripheral to memory, bytes, destination incrementing, ping-pong
+#define RX_DMA_CONTROL (UDMA_CHCTL_DSTINC_8 | UDMA_CHCTL_DSTSIZE_8 | UDMA_CHCTL_SRCINC_NONE \
+                        | UDMA_CHCTL_SRCSIZE_8 | UDMA_CHCTL_ARBSIZE_1 \
+                        | ((UART1_RX_BUFFER_SIZE - 1) << UDMA_CHCTL_XFERSIZE_S) \
+                        | UDMA_CHCTL_XFERMODE_PINGPONG)
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static uint8_t rxBuffer[2][UART1_RX_BUFFER_SIZE];
+static uint8_t rxNextHalf = 0;                       // half that completes next (0 = primary)
+static UART1_RX_CALLBACK rxCallback = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Initialize UART1
+void initUart1(void)
+{
+    // Enable clocks
+    SYSCTL_RCGCUART_R |= SYSCTL_RCGCUART_R1;
+    _delay_cycles(3);
+    enablePort(PORTB);
+
+    // Configure UART1 pins
+    selectPinPushPullOutput(UART_TX_1);
+    selectPinDigitalInput(UART_RX_1);
+    setPinAuxFunction(UART_TX_1, GPIO_PCTL_PB1_U1TX);
+    setPinAuxFunction(UART_RX_1, GPIO_PCTL_PB0_U1RX);
+
+    // Configure UART1 with default baud rate
+    UART1_CTL_R = 0;                                    // turn-off UART1 to allow safe programming
+    UART1_CC_R = UART_CC_CS_SYSCLK;                     // use system clock (usually 40 MHz)
+}
+
+// Set baud rate as function of instruction cycle frequency
+void setUart1BaudRate(uint32_t baudRate, uint32_t fcyc)
+{
+    uint32_t divisorTimes128 = (fcyc * 8) / baudRate;   // calculate divisor (r) in units of 1/128,
+                                                        // where r = fcyc / 16 * baudRate
+    divisorTimes128 += 1;                               // add 1/128 to allow rounding
+    UART1_CTL_R = 0;                                    // turn-off UART1 to allow safe programming
+    UART1_IBRD_R = divisorTimes128 >> 7;                // set integer value to floor(r)
+    UART1_FBRD_R = ((divisorTimes128) >> 1) & 63;       // set fractional value to round(fract(r)*64)
+    UART1_LCRH_R = UART_LCRH_WLEN_8 | UART_LCRH_FEN;    // configure for 8N1 w/ 16-level FIFO
+    UART1_CTL_R = UART_CTL_TXE | UART_CTL_RXE | UART_CTL_UARTEN;
+                                                        // turn-on UART1
+}
+
+// Blocking function that writes a serial character when the UART buffer is not full
+void putcUart1(uint8_t c)
+{
+    while (UART1_FR_R & UART_FR_TXFF);               // wait if uart1 tx fifo full
+    UART1_DR_R = c;                                  // write character to fifo
+}
+
+// Blocking function that writes a string when the UART buffer is not full
+void putsUart1(char* str)
+{
+    uint8_t i = 0;
+    while (str[i] != '\0')
+        putcUart1(str[i++]);
+}
+
+// Blocking function that returns with serial data once the buffer is not empty
+uint8_t getcUart1(void)
+{
+    while (UART1_FR_R & UART_FR_RXFE);               // wait if uart1 rx fifo empty
+    return UART1_DR_R & 0xFF;                        // get character from fifo
+}
+
+// Returns the status of the receive buffer
+bool kbhitUart1(void)
+{
+    return !(UART1_FR_R & UART_FR_RXFE);
+}
+
+// Arm one half of the ping-pong pair to receive the next UART1_RX_BUFFER_SIZE bytes
+static void armRxHalf(uint8_t half)
+{
+    setUdmaTransfer(RX_DMA_CHANNEL, half, (uint32_t)&UART1_DR_R,
+                    (uint32_t)&rxBuffer[half][UART1_RX_BUFFER_SIZE - 1], RX_DMA_CONTROL);
+}
+
+// Start streaming received bytes into the ping-pong buffers without cpu involvement
+// initUdma() must be called first
+void startUart1RxDma(UART1_RX_CALLBACK callback)
+{
+    rxCallback = callback;
+    rxNextHalf = 0;
+
+    disableUdmaChannel(RX_DMA_CHANNEL);
+    selectUdmaChannelSource(RX_DMA_CHANNEL, RX_DMA_ENCODING);
+    armRxHalf(0);
+    armRxHalf(1);
+    UDMA_ALTCLR_R = 1 << RX_DMA_CHANNEL;             // start with the primary half
+    enableUdmaChannel(RX_DMA_CHANNEL);
+
+    UART1_DMACTL_R = UART_DMACTL_RXDMAE;             // request uDMA service while rx fifo has data
+    enableNvicInterrupt(INT_UART1);                  // completion is signaled on the UART1 vector
+}
+
+// Stop streaming, returning UART1 to polled operation
+void stopUart1RxDma(void)
+{
+    UART1_DMACTL_R = 0;
+    disableUdmaChannel(RX_DMA_CHANNEL);
+    disableNvicInterrupt(INT_UART1);
+    rxCallback = 0;
+}
+
+// UART1 interrupt service routine handing completed receive halves to the callback
+void uart1Isr(void)
+{
+    if (UDMA_CHIS_R & (1 << RX_DMA_CHANNEL))
+    {
+        UDMA_CHIS_R = 1 << RX_DMA_CHANNEL;           // clear uDMA completion flag
+        while (isUdmaTransferDone(RX_DMA_CHANNEL, rxNextHalf))
+        {
+            armRxHalf(rxNextHalf);                   // re-arm before the other half completes
+            if (rxCallback)
+                rxCallback(rxBuffer[rxNextHalf], UART1_RX_BUFFER_SIZE);
+            rxNextHalf ^= 1;
+        }
+    }
+}
@@ -0,0 +1,48 @@
+// UART1 Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// UART Interface:
+//   U1TX (PB1) and U1RX (PB0) are connected to the RPLIDAR
+// uDMA:
+//   Channel 22 (encoding 0) moves received bytes into two ping-pong buffers
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef UART1_H_
+#define UART1_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Size of each receive half (max 1024)
+#define UART1_RX_BUFFER_SIZE 100
+
+// Called from uart1Isr with a full receive half while the other half fills
+// The buffer must be consumed before the other half completes
+typedef void (*UART1_RX_CALLBACK)(uint8_t buffer[], uint16_t length);
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initUart1(void);
+void setUart1BaudRate(uint32_t baudRate, uint32_t fcyc);
+void putcUart1(uint8_t c);
+void putsUart1(char* str);
+uint8_t getcUart1(void);
+bool kbhitUart1(void);
+void startUart1RxDma(UART1_RX_CALLBACK callback);
+void stopUart1RxDma(void);
+void uart1Isr(void);
+
+#endif
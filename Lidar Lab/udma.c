@@ -0,0 +1,93 @@
+// uDMA Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// uDMA controller with a 1 KiB aligned channel control table in SRAM
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "udma.h"
+
+// Each control table entry is 4 words: source end, destination end, control, unused
+// The alternate entries start after the 32 primary entries
+#define ENTRY_WORDS 4
+#define ALT_OFFSET  (32 * ENTRY_WORDS)
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+#pragma DATA_ALIGN(udmaTable, 1024)
+static volatile uint32_t udmaTable[2 * 32 * ENTRY_WORDS];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Initialize uDMA controller
+void initUdma(void)
+{
+    // Enable clocks
+    SYSCTL_RCGCDMA_R |= SYSCTL_RCGCDMA_R0;
+    _delay_cycles(3);
+
+    UDMA_CFG_R = UDMA_CFG_MASTEN;                    // enable controller
+    UDMA_CTLBASE_R = (uint32_t)udmaTable;            // point to channel control table
+}
+
+// Select which peripheral drives a channel (see channel assignment table in the datasheet)
+void selectUdmaChannelSource(uint8_t channel, uint8_t encoding)
+{
+    volatile uint32_t* p = (uint32_t*) &UDMA_CHMAP0_R;
+    uint32_t shift = (channel & 7) * 4;
+    p += channel >> 3;
+    *p &= ~(15 << shift);
+    *p |= encoding << shift;
+
+    UDMA_PRIOCLR_R = 1 << channel;                   // default priority
+    UDMA_USEBURSTCLR_R = 1 << channel;               // respond to single and burst requests
+    UDMA_REQMASKCLR_R = 1 << channel;                // allow peripheral requests
+}
+
+// Write the primary or alternate control structure of a channel
+// srcEnd and dstEnd are the addresses of the last item transferred
+void setUdmaTransfer(uint8_t channel, bool alternate, uint32_t srcEnd, uint32_t dstEnd, uint32_t control)
+{
+    volatile uint32_t* p = &udmaTable[channel * ENTRY_WORDS];
+    if (alternate)
+        p += ALT_OFFSET;
+    p[0] = srcEnd;
+    p[1] = dstEnd;
+    p[2] = control;
+}
+
+// Returns true once the controller has finished a control structure (mode set to stop)
+bool isUdmaTransferDone(uint8_t channel, bool alternate)
+{
+    volatile uint32_t* p = &udmaTable[channel * ENTRY_WORDS];
+    if (alternate)
+        p += ALT_OFFSET;
+    return (p[2] & UDMA_CHCTL_XFERMODE_M) == UDMA_CHCTL_XFERMODE_STOP;
+}
+
+void enableUdmaChannel(uint8_t channel)
+{
+    UDMA_ENASET_R = 1 << channel;
+}
+
+void disableUdmaChannel(uint8_t channel)
+{
+    UDMA_ENACLR_R = 1 << channel;
+}
@@ -0,0 +1,35 @@
+// uDMA Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// uDMA controller with a 1 KiB aligned channel control table in SRAM
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef UDMA_H_
+#define UDMA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initUdma(void);
+void selectUdmaChannelSource(uint8_t channel, uint8_t encoding);
+void setUdmaTransfer(uint8_t channel, bool alternate, uint32_t srcEnd, uint32_t dstEnd, uint32_t control);
+bool isUdmaTransferDone(uint8_t channel, bool alternate);
+void enableUdmaChannel(uint8_t channel);
+void disableUdmaChannel(uint8_t channel);
+
+#endif
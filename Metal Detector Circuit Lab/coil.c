@@ -0,0 +1,204 @@
+// Coil Sampler Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// Coil voltage on AIN0 (PE3), oscillator drive reference on AIN1 (PE2),
+//   both ac coupled and biased to mid-supply
+// TIMER2A triggers ADC0 SS1 at COIL_SAMPLE_RATE, SS1 converts AIN0 then AIN1 1 us apart
+// uDMA channel 15 moves the pairs into ping-pong blocks, completion is signaled on
+//   the ADC0 SS1 vector, which runs the Goertzel filter on both channels of the block
+// SysTick runs free to time the block processing
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "gpio.h"
+#include "udma.h"
+#include "goertzel.h"
+#include "coil.h"
+
+// Pins
+#define COIL_IN PORTE,3
+#define REFERENCE_IN PORTE,2
+
+#define ADC_MIDSCALE 2048
+
+#define COIL_DMA_CHANNEL 15                          // ADC0 SS1
+#define COIL_DMA_ENCODING 0
+#define COIL_DMA_CONTROL (UDMA_CHCTL_DSTINC_16 | UDMA_CHCTL_DSTSIZE_16 | UDMA_CHCTL_SRCINC_NONE \
+                          | UDMA_CHCTL_SRCSIZE_16 | UDMA_CHCTL_ARBSIZE_2 \
+                          | ((COIL_BLOCK_PAIRS * 2 - 1) << UDMA_CHCTL_XFERSIZE_S) \
+                          | UDMA_CHCTL_XFERMODE_PINGPONG)
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// Interleaved AIN0, AIN1 pairs
+static uint16_t block[2][COIL_BLOCK_PAIRS * 2];
+static uint8_t nextHalf = 0;
+
+static volatile int32_t coefficient = 0;
+static COIL_RESULT result;
+static volatile bool resultReady = false;
+static uint32_t overrunCount = 0;
+static uint32_t maxCycles = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// initUdma() must be called first
+void initCoil(void)
+{
+    // Enable clocks
+    SYSCTL_RCGCADC_R |= SYSCTL_RCGCADC_R0;
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R2;
+    enablePort(PORTE);
+    _delay_cycles(16);
+
+    // Configure AIN0 and AIN1 as analog inputs
+    selectPinAnalogInput(COIL_IN);
+    selectPinAnalogInput(REFERENCE_IN);
+
+    // Configure ADC0 SS1 to convert AIN0 then AIN1 on each timer trigger
+    ADC0_ACTSS_R &= ~ADC_ACTSS_ASEN1;                // disable SS1 for programming
+    ADC0_PC_R = ADC_PC_SR_1M;                        // 1 Msps conversion rate
+    ADC0_SAC_R = 0;                                  // no hardware averaging, it would lower the rate
+    ADC0_EMUX_R = (ADC0_EMUX_R & ~ADC_EMUX_EM1_M) | ADC_EMUX_EM1_TIMER;
+    ADC0_SSMUX1_R = 0 | (1 << 4);                    // AIN0, then AIN1
+    ADC0_SSCTL1_R = ADC_SSCTL1_END1 | ADC_SSCTL1_IE1;
+    ADC0_IM_R &= ~ADC_IM_MASK1;                      // conversions are collected by uDMA, not the cpu
+
+    // Configure Timer 2 as the sample clock
+    TIMER2_CTL_R &= ~TIMER_CTL_TAEN;                 // turn-off timer before reconfiguring
+    TIMER2_CFG_R = TIMER_CFG_32_BIT_TIMER;           // configure as 32-bit timer (A+B)
+    TIMER2_TAMR_R = TIMER_TAMR_TAMR_PERIOD;          // configure for periodic mode (count down)
+    TIMER2_TAILR_R = 40000000 / COIL_SAMPLE_RATE - 1;
+    TIMER2_IMR_R = 0;                                // no interrupts, only the adc trigger
+    TIMER2_CTL_R |= TIMER_CTL_TAOTE;                 // trigger the adc on timeout
+
+    // Free running SysTick for timing the filter
+    NVIC_ST_RELOAD_R = NVIC_ST_RELOAD_M;
+    NVIC_ST_CURRENT_R = 0;
+    NVIC_ST_CTRL_R = NVIC_ST_CTRL_CLK_SRC | NVIC_ST_CTRL_ENABLE;
+}
+
+static void armBlock(uint8_t half)
+{
+    setUdmaTransfer(COIL_DMA_CHANNEL, half, (uint32_t)&ADC0_SSFIFO1_R,
+                    (uint32_t)&block[half][COIL_BLOCK_PAIRS * 2 - 1], COIL_DMA_CONTROL);
+}
+
+static void startBlocks(void)
+{
+    nextHalf = 0;
+    disableUdmaChannel(COIL_DMA_CHANNEL);
+    selectUdmaChannelSource(COIL_DMA_CHANNEL, COIL_DMA_ENCODING);
+    armBlock(0);
+    armBlock(1);
+    UDMA_ALTCLR_R = 1 << COIL_DMA_CHANNEL;           // start with the primary block
+    enableUdmaChannel(COIL_DMA_CHANNEL);
+}
+
+void startCoil(void)
+{
+    resultReady = false;
+    overrunCount = 0;
+    maxCycles = 0;
+    startBlocks();
+    ADC0_OSTAT_R = ADC_OSTAT_OV1;                    // clear any old overflow
+    ADC0_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1
+    NVIC_EN0_R = 1 << (INT_ADC0SS1-16);              // turn-on interrupt 31 (ADC0SS1)
+    TIMER2_CTL_R |= TIMER_CTL_TAEN;                  // turn-on sample clock
+}
+
+void stopCoil(void)
+{
+    TIMER2_CTL_R &= ~TIMER_CTL_TAEN;
+    NVIC_DIS0_R = 1 << (INT_ADC0SS1-16);
+    ADC0_ACTSS_R &= ~ADC_ACTSS_ASEN1;
+    disableUdmaChannel(COIL_DMA_CHANNEL);
+}
+
+// Tunes the filter to the oscillator frequency, taken up from the next block
+void setCoilFrequency(uint32_t frequency)
+{
+    coefficient = getGoertzelCoefficient(frequency, COIL_SAMPLE_RATE);
+}
+
+// Copies the newest result, returns false if there is none since the last call
+bool readCoilResult(COIL_RESULT *newResult)
+{
+    if (!resultReady)
+        return false;
+    NVIC_DIS0_R = 1 << (INT_ADC0SS1-16);             // keep the isr from writing during the copy
+    *newResult = result;
+    resultReady = false;
+    NVIC_EN0_R = 1 << (INT_ADC0SS1-16);
+    return true;
+}
+
+// Blocks lost because the filter or adc fell behind the sample rate
+uint32_t getCoilOverrunCount(void)
+{
+    return overrunCount;
+}
+
+// Longest filter time seen, one block lasts COIL_BLOCK_PAIRS * 40 MHz / COIL_SAMPLE_RATE cycles
+uint32_t getCoilMaxCycles(void)
+{
+    return maxCycles;
+}
+
+// ADC0 SS1 interrupt service routine, runs once per completed block
+void coilIsr(void)
+{
+    uint32_t start;
+    uint32_t cycles;
+    int32_t c;
+
+    if (!(UDMA_CHIS_R & (1 << COIL_DMA_CHANNEL)))
+        return;
+    UDMA_CHIS_R = 1 << COIL_DMA_CHANNEL;             // clear uDMA completion flag
+
+    while (isUdmaTransferDone(COIL_DMA_CHANNEL, nextHalf))
+    {
+        start = NVIC_ST_CURRENT_R;
+        c = coefficient;
+        runGoertzel(&result.coil, &block[nextHalf][0], COIL_BLOCK_PAIRS, 2, c, ADC_MIDSCALE);
+        runGoertzel(&result.reference, &block[nextHalf][1], COIL_BLOCK_PAIRS, 2, c, ADC_MIDSCALE);
+        cycles = (start - NVIC_ST_CURRENT_R) & NVIC_ST_RELOAD_M;
+
+        // Re-armed only after filtering, so a block still being read is never overwritten
+        armBlock(nextHalf);
+        nextHalf ^= 1;
+
+        result.coefficient = c;
+        result.cycles = cycles;
+        if (cycles > maxCycles)
+            maxCycles = cycles;
+        if (resultReady)
+            overrunCount++;                          // previous result was never read
+        resultReady = true;
+    }
+
+    // Both blocks filled before one was re-armed, so the channel stopped and the fifo overflowed
+    if (!(UDMA_ENASET_R & (1 << COIL_DMA_CHANNEL)) || (ADC0_OSTAT_R & ADC_OSTAT_OV1))
+    {
+        overrunCount++;
+        startBlocks();
+        ADC0_OSTAT_R = ADC_OSTAT_OV1;
+    }
+}
@@ -0,0 +1,57 @@
+// Coil Sampler Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// Coil voltage on AIN0 (PE3), oscillator drive reference on AIN1 (PE2),
+//   both ac coupled and biased to mid-supply
+// TIMER2A triggers ADC0 SS1 at COIL_SAMPLE_RATE, SS1 converts AIN0 then AIN1 1 us apart
+// uDMA channel 15 moves the pairs into ping-pong blocks, completion is signaled on
+//   the ADC0 SS1 vector, which runs the Goertzel filter on both channels of the block
+// SysTick runs free to time the block processing
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef COIL_H_
+#define COIL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "goertzel.h"
+
+// 320 kHz keeps a 32-128 kHz excitation between 0.2 and 0.8 pi, 640 ksps of the 1 Msps adc
+#define COIL_SAMPLE_RATE 320000
+#define COIL_BLOCK_PAIRS 512                         // 1.6 ms, 1024 transfers (uDMA maximum)
+#define COIL_CHANNEL_DELAY_NS 1000                   // AIN1 is converted one adc period after AIN0
+#define COIL_BLOCK_CYCLES (40000000 / COIL_SAMPLE_RATE * COIL_BLOCK_PAIRS)  // filter budget per block
+
+typedef struct _COIL_RESULT
+{
+    GOERTZEL coil;
+    GOERTZEL reference;
+    int32_t coefficient;                             // used for this block
+    uint32_t cycles;                                 // to filter both channels of the block
+} COIL_RESULT;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initCoil(void);
+void startCoil(void);
+void stopCoil(void);
+void setCoilFrequency(uint32_t frequency);
+bool readCoilResult(COIL_RESULT *result);
+uint32_t getCoilOverrunCount(void);
+uint32_t getCoilMaxCycles(void);
+void coilIsr(void);
+
+#endif
@@ -0,0 +1,68 @@
+// Command Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Commands arrive as USER_DATA lines from the UART0 line editor
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef COMMAND_H_
+#define COMMAND_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "uart0.h"
+
+// Hash buckets for the command table (power of 2, at least twice the number of commands)
+#define COMMAND_BUCKETS 32
+
+// Arguments after the command name, converted according to the command's argument types
+typedef struct _COMMAND_ARGS
+{
+    uint8_t count;
+    int32_t integer[MAX_FIELDS];                     // value of each 'n' argument, 0 otherwise
+    char *string[MAX_FIELDS];                        // text of every argument
+} COMMAND_ARGS;
+
+typedef void (*COMMAND_HANDLER)(const COMMAND_ARGS *args);
+
+/*
+ * One registry entry
+ *  argTypes : one character per argument, 'n' numeric or 'a' alpha (as in USER_DATA fieldType),
+ *             arguments past minArgs are optional
+ */
+typedef struct _COMMAND
+{
+    const char *name;
+    uint8_t minArgs;
+    const char *argTypes;
+    COMMAND_HANDLER handler;
+} COMMAND;
+
+typedef enum _COMMAND_STATUS
+{
+    COMMAND_OK,
+    COMMAND_EMPTY,
+    COMMAND_UNKNOWN,
+    COMMAND_MISSING_ARGUMENT,
+    COMMAND_INVALID_ARGUMENT
+} COMMAND_STATUS;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+bool initCommands(const COMMAND table[], uint8_t count);
+COMMAND_STATUS runCommand(USER_DATA *data);
+void putCommandStatusUart0(COMMAND_STATUS status);
+
+#endif
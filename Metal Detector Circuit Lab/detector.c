@@ -0,0 +1,118 @@
+// Detector Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// None, operates on the oscillator frequency passed in by the caller
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "detector.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Thresholds are deviations from the baseline in mHz, release must be below detect
+void initDetector(DETECTOR *detector, int32_t detectThreshold, int32_t releaseThreshold, uint32_t holdUs)
+{
+    if (releaseThreshold > detectThreshold)
+        releaseThreshold = detectThreshold;
+    detector->detectThreshold = detectThreshold;
+    detector->releaseThreshold = releaseThreshold;
+    detector->holdUs = holdUs;
+    resetDetectorBaseline(detector);
+}
+
+// The next measurement becomes the baseline, use with no target near the coil
+void resetDetectorBaseline(DETECTOR *detector)
+{
+    detector->baselineValid = false;
+    detector->deviation = 0;
+    detector->detected = false;
+}
+
+static int32_t absolute(int32_t value)
+{
+    return value < 0 ? -value : value;
+}
+
+// Returns true while a target is detected
+bool updateDetector(DETECTOR *detector, uint32_t frequencyMilliHz, uint32_t timeUs)
+{
+    int64_t frequency = (int64_t)frequencyMilliHz << DETECTOR_BASELINE_SHIFT;
+    uint32_t elapsed;
+    int32_t magnitude;
+
+    if (!detector->baselineValid)
+    {
+        detector->baseline = frequency;
+        detector->baselineValid = true;
+        detector->trackTime = timeUs;
+    }
+    detector->deviation = (frequency - detector->baseline) >> DETECTOR_BASELINE_SHIFT;
+    magnitude = absolute(detector->deviation);
+
+    if (!detector->detected)
+    {
+        if (magnitude >= detector->detectThreshold)
+        {
+            detector->detected = true;
+            detector->detectTime = timeUs;
+        }
+    }
+    else if (magnitude < detector->releaseThreshold && timeUs - detector->detectTime >= detector->holdUs)
+        detector->detected = false;
+
+    // Track drift over the elapsed time, slowly once the deviation passes release so a target
+    // is not absorbed, and not at all while one is detected
+    elapsed = timeUs - detector->trackTime;
+    if (elapsed >= DETECTOR_TRACK_PERIOD_US)
+    {
+        detector->trackTime = timeUs;
+        if (!detector->detected)
+        {
+            uint32_t timeConstant = magnitude < detector->releaseThreshold
+                                  ? DETECTOR_TIME_CONSTANT_US : DETECTOR_SLOW_TIME_CONSTANT_US;
+            if (elapsed > timeConstant)
+                elapsed = timeConstant;
+            detector->baseline += (frequency - detector->baseline) * elapsed / timeConstant;
+        }
+    }
+    return detector->detected;
+}
+
+// Baseline frequency in mHz
+uint32_t getDetectorBaseline(const DETECTOR *detector)
+{
+    return detector->baseline >> DETECTOR_BASELINE_SHIFT;
+}
+
+// Deviation from the baseline in mHz
+int32_t getDetectorDeviation(const DETECTOR *detector)
+{
+    return detector->deviation;
+}
+
+// Deviation as a percentage of the detect threshold, 100 is the edge of detection
+uint32_t getDetectorStrength(const DETECTOR *detector)
+{
+    if (detector->detectThreshold <= 0)
+        return 0;
+    return (uint64_t)absolute(detector->deviation) * 100 / detector->detectThreshold;
+}
+
+bool isDetected(const DETECTOR *detector)
+{
+    return detector->detected;
+}
@@ -0,0 +1,67 @@
+// Detector Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// None, operates on the oscillator frequency passed in by the caller
+//
+// A target shifts the LC oscillator away from its baseline frequency, up for
+// non-ferrous metal and down for ferrous metal.
+// The baseline follows slow drift with an IIR filter. Its time constant is set in
+// time rather than measurements, so it is the same at any gate or reciprocal rate.
+// Tracking slows down while the deviation is between the release and detect
+// thresholds, and stops while a target is detected.
+// Detection uses the size of the deviation, with separate detect and release
+// thresholds and a minimum hold time so the output does not chatter at the edge
+// of range.
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef DETECTOR_H_
+#define DETECTOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Baseline fraction bits, time constant, and the slower time constant used between the
+// release and detect thresholds so a slowly approaching target is not absorbed
+// The baseline steps at most every DETECTOR_TRACK_PERIOD_US so fast gates still move it
+#define DETECTOR_BASELINE_SHIFT 10
+#define DETECTOR_TIME_CONSTANT_US 10000000
+#define DETECTOR_SLOW_TIME_CONSTANT_US 160000000
+#define DETECTOR_TRACK_PERIOD_US 10000
+
+typedef struct _DETECTOR
+{
+    int64_t baseline;                                // mHz << DETECTOR_BASELINE_SHIFT
+    bool baselineValid;
+    uint32_t trackTime;                              // us, when the baseline last stepped
+    int32_t deviation;                               // mHz from baseline, positive for non-ferrous
+    int32_t detectThreshold;                         // mHz
+    int32_t releaseThreshold;                        // mHz
+    uint32_t holdUs;
+    uint32_t detectTime;                             // us, when the current detection started
+    bool detected;
+} DETECTOR;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initDetector(DETECTOR *detector, int32_t detectThreshold, int32_t releaseThreshold, uint32_t holdUs);
+void resetDetectorBaseline(DETECTOR *detector);
+bool updateDetector(DETECTOR *detector, uint32_t frequencyMilliHz, uint32_t timeUs);
+uint32_t getDetectorBaseline(const DETECTOR *detector);
+int32_t getDetectorDeviation(const DETECTOR *detector);
+uint32_t getDetectorStrength(const DETECTOR *detector);
+bool isDetected(const DETECTOR *detector);
+
+#endif
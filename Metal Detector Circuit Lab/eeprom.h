@@ -0,0 +1,50 @@
+// EEPROM Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// On-chip EEPROM, 2 KiB as 32 blocks of 16 words
+//
+// Records hold calibration that must survive a power cycle, one record per block:
+//   word 0      : EEPROM_RECORD_TAG | block << 8 | word count
+//   word 1-n    : data
+//   word n+1    : one's complement of the sum of words 0-n
+// Erased words read 0xFFFFFFFF, so a block never written fails the tag check
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef EEPROM_H_
+#define EEPROM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define EEPROM_BLOCK_WORDS 16
+#define EEPROM_RECORD_WORDS (EEPROM_BLOCK_WORDS - 2)
+#define EEPROM_RECORD_TAG 0x43410000
+
+// Blocks are fixed per lab so a board moved between labs does not misread another lab's record
+#define EEPROM_BLOCK_STRAIN_CALIBRATION 1
+#define EEPROM_BLOCK_BACK_EMF_FIT 2
+#define EEPROM_BLOCK_METAL_DETECTOR 3
+#define EEPROM_BLOCK_SPEED_GAINS 4
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+bool initEeprom(void);
+uint32_t readEeprom(uint16_t address);
+bool writeEeprom(uint16_t address, uint32_t data);
+bool loadEepromRecord(uint8_t block, uint32_t data[], uint8_t count);
+bool saveEepromRecord(uint8_t block, const uint32_t data[], uint8_t count);
+
+#endif
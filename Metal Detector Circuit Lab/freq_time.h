@@ -0,0 +1,45 @@
+// Frequency Counter Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// SIGNAL_IN on PC6 (WT1CCP0), configured by the caller
+//   WTIMER1A counts rising edges, free running
+//   TIMER1A interrupts once per subgate (gate / FREQ_SUBGATES)
+// The frequency is taken over the newest FREQ_SUBGATES subgates, so it keeps
+// the resolution of the whole gate but updates every subgate
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef FREQ_TIME_H_
+#define FREQ_TIME_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FREQ_SUBGATES 10
+#define FREQ_MIN_GATE_MS 1
+#define FREQ_MAX_GATE_MS 1000
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void enableCounterMode(void);
+void disableCounterMode(void);
+bool setCounterGate(int32_t gateMs);
+uint16_t getCounterGate(void);
+bool isCounterUpdated(void);
+uint32_t getCounterFrequency(void);
+uint32_t getCounterFrequencyMilliHz(void);
+void timer1Isr(void);
+
+#endif
@@ -0,0 +1,84 @@
+// Goertzel Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// None, operates on blocks of adc samples passed in by the caller
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <math.h>
+#include "goertzel.h"
+
+#define PI 3.14159265f
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Returns 2 cos(2 pi f / fs) in Q14
+int32_t getGoertzelCoefficient(uint32_t frequency, uint32_t sampleRate)
+{
+    float w = 2 * PI * frequency / sampleRate;
+    return lroundf(2 * cosf(w) * (1 << GOERTZEL_Q));
+}
+
+// Runs the resonator over count samples taken stride apart, with offset (the adc mid-scale) removed
+// The inner loop is a load, a 32 x 32 multiply-long and three adds per sample
+void runGoertzel(GOERTZEL *state, const uint16_t samples[], uint16_t count, uint8_t stride,
+                 int32_t coefficient, int32_t offset)
+{
+    int32_t s0;
+    int32_t s1 = 0;
+    int32_t s2 = 0;
+
+    while (count--)
+    {
+        s0 = (int32_t)*samples - offset + (int32_t)(((int64_t)coefficient * s1) >> GOERTZEL_Q) - s2;
+        s2 = s1;
+        s1 = s0;
+        samples += stride;
+    }
+    state->s1 = s1;
+    state->s2 = s2;
+}
+
+// cos(w) and sin(w) from the coefficient, w is between 0 and pi so sin(w) is positive
+static void getGoertzelRotation(int32_t coefficient, float *cosine, float *sine)
+{
+    *cosine = (float)coefficient / (2 << GOERTZEL_Q);
+    *sine = sqrtf(1 - *cosine * *cosine);
+}
+
+// Amplitude of the tone in adc counts
+float getGoertzelAmplitude(const GOERTZEL *state, int32_t coefficient, uint16_t count)
+{
+    float cosine;
+    float sine;
+    float real;
+    float imaginary;
+
+    getGoertzelRotation(coefficient, &cosine, &sine);
+    real = state->s1 - state->s2 * cosine;
+    imaginary = state->s2 * sine;
+    return 2 * sqrtf(real * real + imaginary * imaginary) / count;
+}
+
+// Phase of the tone in radians, relative to the same block run on another channel
+float getGoertzelPhase(const GOERTZEL *state, int32_t coefficient)
+{
+    float cosine;
+    float sine;
+
+    getGoertzelRotation(coefficient, &cosine, &sine);
+    return atan2f(state->s2 * sine, state->s1 - state->s2 * cosine);
+}
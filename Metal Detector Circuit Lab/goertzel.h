@@ -0,0 +1,50 @@
+// Goertzel Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// None, operates on blocks of adc samples passed in by the caller
+//
+// Single frequency DFT: s[n] = x[n] + c * s[n-1] - s[n-2], c = 2 cos(w)
+// After the block, X = s[n-1] - s[n-2] * exp(-jw), so
+//   amplitude = 2 |X| / count
+//   phase     = arg(X), common to every channel run with the same c and count,
+//               so phase differences between channels need no further correction
+// Samples are 12 bits, the state stays within 32 bits for blocks of up to 1024
+// samples while w is kept between 0.2 pi and 0.8 pi
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef GOERTZEL_H_
+#define GOERTZEL_H_
+
+#include <stdint.h>
+
+// Coefficient c = 2 cos(w) in Q14, so -32768 to 32767 covers -2 to 2
+#define GOERTZEL_Q 14
+
+typedef struct _GOERTZEL
+{
+    int32_t s1;                                      // s[n-1]
+    int32_t s2;                                      // s[n-2]
+} GOERTZEL;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+int32_t getGoertzelCoefficient(uint32_t frequency, uint32_t sampleRate);
+void runGoertzel(GOERTZEL *state, const uint16_t samples[], uint16_t count, uint8_t stride,
+                 int32_t coefficient, int32_t offset);
+float getGoertzelAmplitude(const GOERTZEL *state, int32_t coefficient, uint16_t count);
+float getGoertzelPhase(const GOERTZEL *state, int32_t coefficient);
+
+#endif
@@ -4,53 +4,196 @@
  * 1001337439
  */
 #include <stdint.h>
-#include <stdio.h>
 #include <stdbool.h>
 #include "uart0.h"
+#include "format.h"
+#include "telemetry.h"
+#include "command.h"
+#include "eeprom.h"
+#include "freq_time.h"
+#include "detector.h"
+#include "udma.h"
+#include "coil.h"
 #include "wait.h"
 #include "gpio.h"
 #include "clock.h"
 #include "tm4c123gh6pm.h"
 
 uint32_t frequency = 0;
-uint32_t time = 0;
+uint32_t frequencyMilliHz = 0;
+
+// Frequency modes
+//   gate:       WTIMER1 counts edges over a sliding gate of 1 ms to 1 s (freq_time.c),
+//               updated every tenth of the gate (1 s gate: 1 Hz resolution, 10 updates/s)
+//   reciprocal: WTIMER1 timestamps every edge against the 40 MHz clock and the frequency is
+//               taken from the time spanned by reciprocalCycles periods
+//               (1024 periods at 105 kHz: ~100 updates/s, 0.27 Hz resolution)
+//   goertzel:   gate mode, and the coil is also sampled by the adc (coil.c) and filtered at the
+//               gated frequency, giving coil amplitude and phase against the drive for discrimination
+typedef enum _FREQUENCY_MODE
+{
+    FREQUENCY_GATE,
+    FREQUENCY_RECIPROCAL,
+    FREQUENCY_GOERTZEL
+} FREQUENCY_MODE;
+
+#define DEFAULT_RECIPROCAL_CYCLES 1024
+
+// Measurements can arrive every 100 us with a 1 ms gate, output is limited to one per period
+#define REPORT_PERIOD_US 10000
+
+FREQUENCY_MODE frequencyMode = FREQUENCY_GATE;
+volatile bool frequencyReady = false;
+
+// Reciprocal measurement, written by wideTimer1Isr
+uint32_t reciprocalCycles = DEFAULT_RECIPROCAL_CYCLES;
+uint32_t edgeCount = 0;
+uint32_t firstEdgeTime = 0;
+uint32_t lastEdgeTime = 0;
+bool firstEdgeValid = false;
+volatile uint32_t periodTicks = 0;
+volatile uint32_t periodCycles = 0;
+uint32_t edgePeriodTicks = 0;                       // mean period of the last span, 0 until known
+uint32_t edgeLimitTicks = 0;                        // edge intervals beyond this hide missed edges
+
+// Target detection on the deviation from the tracked baseline, saved thresholds replace these at boot
+#define DEFAULT_DETECT_HZ 20
+#define DEFAULT_RELEASE_HZ 10
+#define DEFAULT_HOLD_MS 200
+
+DETECTOR detector;
+
+// Goertzel mode results, in 1e-3 adc counts and 1e-3 degrees
+int32_t coilAmplitude = 0;
+int32_t referenceAmplitude = 0;
+int32_t phaseShift = 0;
+uint32_t filterCycles = 0;
 
 // PC6
 #define FREQ_IN_MASK 64
 #define BLUE_LED PORTF,2
 #define GREEN_LED PORTF,3
 
-void enableCounterMode(){
-    // Configure Timer 1 as the time base
-    TIMER1_CTL_R &= ~TIMER_CTL_TAEN;             // turn-off timer before reconfiguring
-    TIMER1_CFG_R = TIMER_CFG_32_BIT_TIMER;       // configure as 32-bit timer (A+B)
-    TIMER1_TAMR_R = TIMER_TAMR_TAMR_PERIOD;      // configure for periodic mode (count down)
-    TIMER1_TAILR_R = 40000000;                   // set load value to 40e6 for 1 Hz interrupt rate
-    TIMER1_IMR_R = TIMER_IMR_TATOIM;             // turn-on interrupts
-    TIMER1_CTL_R |= TIMER_CTL_TAEN;              // turn-on timer
-    NVIC_EN0_R |= 1 << (INT_TIMER1A-16);         // turn-on interrupt 37 (TIMER1A)
-
-    // Configure Wide Timer 1 as counter of external events on CCP0 pin
-    WTIMER1_CTL_R &= ~TIMER_CTL_TAEN;           // turn-off counter before reconfiguring
-    WTIMER1_CFG_R = 4;                    // configure as 32-bit counter (A only)
-    WTIMER1_TAMR_R = TIMER_TAMR_TAMR_CAP | TIMER_TAMR_TACDIR; //configure for edge count mode, count up
-    WTIMER1_CTL_R = 0;                               //
-    WTIMER1_IMR_R = 0;                           // turn-off interrupts
-    WTIMER1_TAV_R = 0;                          // zero counter for first period
-    WTIMER1_CTL_R |= TIMER_CTL_TAEN;            // turn-on counter
-}
-// Frequency counter service publishing latest frequency measurements every second
-void timer1Isr(){
-    frequency = WTIMER1_TAV_R;                   // read counter input
-    WTIMER1_TAV_R = 0;                           // reset counter for next period
-    TIMER1_ICR_R = TIMER_ICR_TATOCINT;           // clear interrupt flag
-}
-
-// Period timer service publishing latest time measurements every positive edge
+void enableGateMode(){
+    // Stop the reciprocal edge interrupt and adc sampling
+    WTIMER1_IMR_R = 0;
+    NVIC_DIS3_R = 1 << (INT_WTIMER1A-16-96);
+    stopCoil();
+
+    // UART0 goes back to priority 0, it only needs to yield to the edge capture isr
+    NVIC_PRI5_R &= ~NVIC_PRI5_INT21_M;
+
+    enableCounterMode();
+    frequencyMode = FREQUENCY_GATE;
+}
+
+void enableGoertzelMode(){
+    enableGateMode();
+    startCoil();
+    frequencyMode = FREQUENCY_GOERTZEL;
+}
+
+void enableTimerMode(uint32_t cycles){
+    // Stop the gate and adc sampling
+    disableCounterMode();
+    stopCoil();
+
+    edgeCount = 0;
+    firstEdgeValid = false;
+    edgePeriodTicks = 0;
+    edgeLimitTicks = 0;
+    reciprocalCycles = cycles;
+
+    // Edges come every ~9.5 us, so the capture isr must preempt the uart isr: WTIMER1A
+    // (interrupt 112) stays at priority 0 and UART0 (interrupt 21) drops to 1
+    NVIC_PRI28_R &= ~0x000000E0;
+    NVIC_PRI5_R = (NVIC_PRI5_R & ~NVIC_PRI5_INT21_M) | (1 << NVIC_PRI5_INT21_S);
+
+    // Configure Wide Timer 1 to capture the 40 MHz time of each rising edge on CCP0 pin
+    WTIMER1_CTL_R &= ~TIMER_CTL_TAEN;                // turn-off counter before reconfiguring
+    WTIMER1_CFG_R = 4;                               // configure as 32-bit counter (A only)
+    WTIMER1_TAMR_R = TIMER_TAMR_TACMR | TIMER_TAMR_TAMR_CAP | TIMER_TAMR_TACDIR; // configure for edge time mode, count up
+    WTIMER1_TAILR_R = 0xFFFFFFFF;                    // free running, wraps after 107 s
+    WTIMER1_CTL_R = TIMER_CTL_TAEVENT_POS;           // measure time from positive edge to positive edge
+    WTIMER1_TAV_R = 0;                               // zero counter
+    WTIMER1_ICR_R = TIMER_ICR_CAECINT;               // clear any stale capture
+    WTIMER1_IMR_R = TIMER_IMR_CAEIM;                 // turn-on interrupts
+    WTIMER1_CTL_R |= TIMER_CTL_TAEN;                 // turn-on counter
+    NVIC_EN3_R = 1 << (INT_WTIMER1A-16-96);          // turn-on interrupt 112 (WTIMER1A)
+    frequencyMode = FREQUENCY_RECIPROCAL;
+}
+// Period timer service timestamping every positive edge
+// Publishes the time spanned by reciprocalCycles periods, the next span starts on the same edge
+// A capture overwritten before it is read hides an edge, leaving an interval of about two
+// periods, so an interval over 1.5 mean periods counts the periods it spans instead of one
+// The first span only sets the mean period and is not published
 void wideTimer1Isr(){
-    time = WTIMER1_TAV_R;                        // read counter input
-    WTIMER1_TAV_R = 0;                           // zero counter for next edge
+    uint32_t edgeTime = WTIMER1_TAR_R;           // time of the captured edge
+    uint32_t interval;
+    uint32_t ticks;
     WTIMER1_ICR_R = TIMER_ICR_CAECINT;           // clear interrupt flag
+    if (!firstEdgeValid){
+        firstEdgeTime = edgeTime;
+        lastEdgeTime = edgeTime;
+        firstEdgeValid = true;
+        return;
+    }
+    interval = edgeTime - lastEdgeTime;
+    lastEdgeTime = edgeTime;
+    if (edgeLimitTicks != 0 && interval > edgeLimitTicks){
+        edgeCount += (interval + edgePeriodTicks / 2) / edgePeriodTicks;
+    }
+    else{
+        edgeCount++;
+    }
+    if (edgeCount >= reciprocalCycles){
+        ticks = edgeTime - firstEdgeTime;
+        if (edgePeriodTicks != 0){
+            periodTicks = ticks;
+            periodCycles = edgeCount;
+            frequencyReady = true;
+        }
+        edgePeriodTicks = ticks / edgeCount;
+        edgeLimitTicks = edgePeriodTicks + edgePeriodTicks / 2;
+        firstEdgeTime = edgeTime;
+        edgeCount = 0;
+    }
+}
+
+// f = cycles * 40 MHz / ticks, rounded
+void updateReciprocalFrequency(){
+    uint32_t ticks;
+    uint32_t cycles;
+
+    // Mask the edge interrupt so both values come from the same span, a pending edge is serviced after
+    WTIMER1_IMR_R = 0;
+    ticks = periodTicks;
+    cycles = periodCycles;
+    WTIMER1_IMR_R = TIMER_IMR_CAEIM;
+    if (ticks == 0){
+        return;
+    }
+    frequencyMilliHz = ((uint64_t)cycles * 40000000000ULL + ticks / 2) / ticks;
+    frequency = (frequencyMilliHz + 500) / 1000;
+}
+
+// Amplitudes of both channels and the coil phase relative to the drive, from one filtered block
+// The reference is converted COIL_CHANNEL_DELAY_NS after the coil, which is added back
+void updateCoilSignal(const COIL_RESULT *result){
+    float phase;
+    phase = getGoertzelPhase(&result->coil, result->coefficient)
+          - getGoertzelPhase(&result->reference, result->coefficient)
+          + 2 * 3.14159265f * frequencyMilliHz * (COIL_CHANNEL_DELAY_NS * 1e-12f);
+    while (phase > 3.14159265f){
+        phase -= 2 * 3.14159265f;
+    }
+    while (phase <= -3.14159265f){
+        phase += 2 * 3.14159265f;
+    }
+    coilAmplitude = getGoertzelAmplitude(&result->coil, result->coefficient, COIL_BLOCK_PAIRS) * 1000;
+    referenceAmplitude = getGoertzelAmplitude(&result->reference, result->coefficient, COIL_BLOCK_PAIRS) * 1000;
+    phaseShift = phase * (180000 / 3.14159265f);
+    filterCycles = result->cycles;
 }
 
 void initHw(){
@@ -72,31 +215,200 @@ void initHw(){
     GPIO_PORTC_PCTL_R |= GPIO_PCTL_PC6_WT1CCP0;
     GPIO_PORTC_DEN_R |= FREQ_IN_MASK;                // enable bit 6 for digital input
 }
+// Console commands, dispatched through the hashed table in command.c
+void binaryCommand(const COMMAND_ARGS *args){
+    setTelemetryMode(TELEMETRY_BINARY);
+}
+
+void textCommand(const COMMAND_ARGS *args){
+    setTelemetryMode(TELEMETRY_TEXT);
+}
+
+// Record: detect threshold (mHz), release threshold (mHz), hold time (us)
+void loadThreshold(){
+    uint32_t record[3];
+    if (loadEepromRecord(EEPROM_BLOCK_METAL_DETECTOR, record, 3)){
+        initDetector(&detector, record[0], record[1], record[2]);
+    }
+}
+
+// threshold DETECT RELEASE [HOLD] saves the thresholds (Hz from baseline) and hold time (ms)
+// threshold alone shows them
+void thresholdCommand(const COMMAND_ARGS *args){
+    uint32_t record[3];
+    uint32_t holdUs = detector.holdUs;
+    if (args->count == 1){
+        putCommandStatusUart0(COMMAND_MISSING_ARGUMENT);
+        return;
+    }
+    if (args->count >= 2){
+        if (args->count == 3){
+            holdUs = args->integer[2] * 1000;
+        }
+        initDetector(&detector, args->integer[0] * 1000, args->integer[1] * 1000, holdUs);
+        record[0] = detector.detectThreshold;
+        record[1] = detector.releaseThreshold;
+        record[2] = detector.holdUs;
+        if (!saveEepromRecord(EEPROM_BLOCK_METAL_DETECTOR, record, 3)){
+            putsUart0("EEPROM write failed\n");
+        }
+    }
+    putsUart0("Detect: ");
+    putFixedUart0(detector.detectThreshold, 3);
+    putsUart0(" (Hz), release: ");
+    putFixedUart0(detector.releaseThreshold, 3);
+    putsUart0(" (Hz), hold: ");
+    putDecUart0(detector.holdUs / 1000, 0);
+    putsUart0(" (ms)\n");
+}
+
+// baseline takes the next measurement as the baseline, with no target near the coil
+void baselineCommand(const COMMAND_ARGS *args){
+    resetDetectorBaseline(&detector);
+}
+
+// mode gate | mode reciprocal [CYCLES] | mode goertzel
+void modeCommand(const COMMAND_ARGS *args){
+    uint32_t cycles = DEFAULT_RECIPROCAL_CYCLES;
+    if (strCmp(args->string[0], "gate") == 0){
+        enableGateMode();
+    }
+    else if (strCmp(args->string[0], "reciprocal") == 0){
+        if (args->count > 1 && args->integer[1] > 0){
+            cycles = args->integer[1];
+        }
+        enableTimerMode(cycles);
+    }
+    else if (strCmp(args->string[0], "goertzel") == 0){
+        enableGoertzelMode();
+    }
+    else{
+        putsUart0("Mode is gate, reciprocal or goertzel\n");
+    }
+}
+
+// gate MS sets the counter gate, gate alone shows it
+void gateCommand(const COMMAND_ARGS *args){
+    if (args->count == 1 && !setCounterGate(args->integer[0])){
+        putsUart0("Gate is 1 to 1000 ms\n");
+    }
+    putsUart0("Gate: ");
+    putDecUart0(getCounterGate(), 0);
+    putsUart0(" (ms)\n");
+}
+
+const COMMAND commands[] =
+{
+    {"binary", 0, "", binaryCommand},
+    {"text", 0, "", textCommand},
+    {"threshold", 0, "nnn", thresholdCommand},
+    {"baseline", 0, "", baselineCommand},
+    {"mode", 1, "an", modeCommand},
+    {"gate", 0, "n", gateCommand}
+};
+
+void processCommand(USER_DATA *data){
+    COMMAND_STATUS status = runCommand(data);
+    if (getTelemetryMode() == TELEMETRY_TEXT){
+        putCommandStatusUart0(status);
+    }
+}
+
 int main(void){
+    USER_DATA data;
+    uint32_t lastReport = 0;
+    int32_t detection[4];
+    int32_t signal[4];
+    COIL_RESULT coilResult;
+
     // Initialize hardware
     initHw();
     initUart0();
     // Setup UART0 baud rate
     setUart0BaudRate(115200, 40e6);
-    enableCounterMode();
-
-    char str[10];
+    initUdma();
+    initCoil();
+    enableGateMode();
+    initTelemetry();
+    startUart0LineInput();
+    if (!initCommands(commands, sizeof(commands) / sizeof(commands[0]))){
+        putsUart0("Command table init failed\n");
+    }
+    initDetector(&detector, DEFAULT_DETECT_HZ * 1000, DEFAULT_RELEASE_HZ * 1000, DEFAULT_HOLD_MS * 1000);
+    if (initEeprom()){
+        loadThreshold();
+    }
 
     while(1){
-        putsUart0("Frequency: ");
-        sprintf(str, "%7lu", frequency);
-        putsUart0(str);
-        putsUart0(" (Hz)\n");
-
-        if (frequency >= 105000){
-        
-            setPinValue(GREEN_LED,1);
+        if (getUart0Line(&data)){
+            processCommand(&data);
+        }
+        if (readCoilResult(&coilResult)){
+            updateCoilSignal(&coilResult);
+        }
+        // Take each new measurement, every subgate when gated or every span when reciprocal
+        if (frequencyMode != FREQUENCY_RECIPROCAL){
+            if (!isCounterUpdated()){
+                continue;
+            }
+            frequencyMilliHz = getCounterFrequencyMilliHz();
+            frequency = (frequencyMilliHz + 500) / 1000;
+            if (frequencyMode == FREQUENCY_GOERTZEL){
+                setCoilFrequency(frequency);
+            }
         }
         else{
-            setPinValue(GREEN_LED,0);
+            if (!frequencyReady){
+                continue;
+            }
+            frequencyReady = false;
+            updateReciprocalFrequency();
+        }
+
+        setPinValue(GREEN_LED, updateDetector(&detector, frequencyMilliHz, getTelemetryTimestamp()));
 
+        if (getTelemetryTimestamp() - lastReport < REPORT_PERIOD_US){
+            continue;
+        }
+        lastReport = getTelemetryTimestamp();
+        if (getTelemetryMode() == TELEMETRY_TEXT){
+            putsUart0("Frequency: ");
+            putFixedUart0(frequencyMilliHz, 3);
+            putsUart0(" (Hz)  Deviation: ");
+            putFixedUart0(getDetectorDeviation(&detector), 3);
+            putsUart0(" (Hz)  Strength: ");
+            putDecUart0(getDetectorStrength(&detector), 3);
+            putsUart0(isDetected(&detector) ? "%  DETECTED\n" : "%\n");
+            if (frequencyMode == FREQUENCY_GOERTZEL){
+                putsUart0("Amplitude: ");
+                putFixedUart0(coilAmplitude, 3);
+                putsUart0(" / ");
+                putFixedUart0(referenceAmplitude, 3);
+                putsUart0(" (counts)  Phase: ");
+                putFixedUart0(phaseShift, 3);
+                putsUart0(" (deg)  Filter: ");
+                putDecUart0(filterCycles, 0);
+                putsUart0(" cycles, ");
+                putDecUart0(getCoilMaxCycles() * 100 / COIL_BLOCK_CYCLES, 0);
+                putsUart0("% peak load  Overruns: ");
+                putDecUart0(getCoilOverrunCount(), 0);
+                putsUart0("\n");
+            }
+        }
+        detection[0] = getDetectorBaseline(&detector);
+        detection[1] = getDetectorDeviation(&detector);
+        detection[2] = getDetectorStrength(&detector);
+        detection[3] = isDetected(&detector);
+        sendTelemetry(TELEMETRY_FREQUENCY, TELEMETRY_U32, &frequency, 1);
+        sendTelemetry(TELEMETRY_FREQUENCY_FINE, TELEMETRY_U32, &frequencyMilliHz, 1);
+        sendTelemetry(TELEMETRY_METAL_DETECTOR, TELEMETRY_I32, detection, 4);
+        if (frequencyMode == FREQUENCY_GOERTZEL){
+            signal[0] = coilAmplitude;
+            signal[1] = referenceAmplitude;
+            signal[2] = phaseShift;
+            signal[3] = filterCycles;
+            sendTelemetry(TELEMETRY_METAL_GOERTZEL, TELEMETRY_I32, signal, 4);
         }
-        waitMicrosecond(100000);
     }
 
 	return 0;
@@ -0,0 +1,204 @@
+// ADC Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// ADC0 and ADC1, sample sequencers SS0-SS3
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "nvic.h"
+#include "adc.h"
+
+#define ADC_CTL_DITHER          0x00000040
+
+// Register offsets from the module base, sequencer registers repeat every 0x20 bytes
+#define OFS_ACTSS    0x000
+#define OFS_RIS      0x004
+#define OFS_IM       0x008
+#define OFS_ISC      0x00C
+#define OFS_OSTAT    0x010
+#define OFS_EMUX     0x014
+#define OFS_USTAT    0x018
+#define OFS_TSSEL    0x01C
+#define OFS_PSSI     0x028
+#define OFS_SAC      0x030
+#define OFS_CTL      0x038
+#define OFS_SSMUX0   0x040
+#define OFS_SSCTL0   0x044
+#define OFS_SSFIFO0  0x048
+#define OFS_SSFSTAT0 0x04C
+#define OFS_SSOP0    0x050
+#define OFS_SS_STEP  0x020
+#define OFS_PC       0xFC4
+#define OFS_CC       0xFC8
+
+#define ADC_REG(adc, offset) (*((volatile uint32_t *)((uint32_t)(adc) + (offset))))
+#define ADC_SS_REG(adc, ss, offset) ADC_REG(adc, (offset) + (ss) * OFS_SS_STEP)
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static const uint8_t depth[4] = {8, 4, 4, 1};
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Enable the module clock, select the PLL time base and 1 Msps, all sequencers off and
+// processor triggered
+void initAdc(ADC adc)
+{
+    // Enable clocks
+    SYSCTL_RCGCADC_R |= adc == ADC0 ? SYSCTL_RCGCADC_R0 : SYSCTL_RCGCADC_R1;
+    _delay_cycles(16);
+
+    // Configure ADC
+    ADC_REG(adc, OFS_ACTSS) = 0;                     // disable all sequencers for programming
+    ADC_REG(adc, OFS_IM) = 0;
+    ADC_REG(adc, OFS_ISC) = 0xF;                     // clear any stale interrupt
+    ADC_REG(adc, OFS_CC) = ADC_CC_CS_SYSPLL;         // select PLL as the time base
+    ADC_REG(adc, OFS_PC) = ADC_PC_SR_1M;             // select 1Msps rate
+    ADC_REG(adc, OFS_EMUX) = 0;                      // processor trigger for all sequencers
+}
+
+// Set hardware averaging of 2^log2AverageCount conversions per step (0-6) for the module
+// Every step of every sequencer then takes 2^log2AverageCount conversion times
+bool setAdcLog2AverageCount(ADC adc, uint8_t log2AverageCount)
+{
+    uint32_t active;
+    if (log2AverageCount > ADC_MAX_LOG2_AVERAGE)
+        return false;
+    active = ADC_REG(adc, OFS_ACTSS) & 0xF;
+    ADC_REG(adc, OFS_ACTSS) &= ~0xF;                 // disable sequencers while averaging changes
+    ADC_REG(adc, OFS_SAC) = log2AverageCount;        // sample HW averaging
+    if (log2AverageCount == 0)
+        ADC_REG(adc, OFS_CTL) &= ~ADC_CTL_DITHER;    // turn-off dithering if no averaging
+    else
+        ADC_REG(adc, OFS_CTL) |= ADC_CTL_DITHER;     // turn-on dithering if averaging
+    ADC_REG(adc, OFS_ACTSS) |= active;
+    return true;
+}
+
+// Convert inputs[0..count-1] (AIN0-AIN11) on each trigger, the last step ends the sequence
+// and raises its interrupt, returns false if the list does not fit the sequencer
+bool setAdcSequence(ADC adc, uint8_t ss, const uint8_t inputs[], uint8_t count)
+{
+    uint32_t mux = 0;
+    uint8_t i;
+    if (ss > 3 || count == 0 || count > depth[ss])
+        return false;
+    for (i = 0; i < count; i++)
+        mux |= (uint32_t)(inputs[i] & 0xF) << (i * 4);
+    disableAdcSequence(adc, ss);
+    ADC_SS_REG(adc, ss, OFS_SSMUX0) = mux;
+    ADC_SS_REG(adc, ss, OFS_SSOP0) = 0;              // results go to the FIFO, not the comparators
+    ADC_SS_REG(adc, ss, OFS_SSCTL0) = (ADC_SSCTL0_END0 | ADC_SSCTL0_IE0) << ((count - 1) * 4);
+    return true;
+}
+
+void setAdcTrigger(ADC adc, uint8_t ss, ADC_TRIGGER trigger)
+{
+    uint32_t emux = ADC_REG(adc, OFS_EMUX);
+    emux &= ~(0xF << (ss * 4));
+    emux |= (uint32_t)trigger << (ss * 4);
+    ADC_REG(adc, OFS_EMUX) = emux;
+}
+
+// Select PWM module 0 or 1 as the source of the ADC_TRIGGER_PWMn trigger of generator n
+void selectAdcPwmModule(ADC adc, uint8_t generator, uint8_t module)
+{
+    uint32_t tssel = ADC_REG(adc, OFS_TSSEL);
+    tssel &= ~(ADC_TSSEL_PS0_M << (generator * 8));
+    tssel |= (uint32_t)(module & 1) << (4 + generator * 8);
+    ADC_REG(adc, OFS_TSSEL) = tssel;
+}
+
+// Start converting on triggers, results left from a previous run are dropped
+void enableAdcSequence(ADC adc, uint8_t ss)
+{
+    while (!(ADC_SS_REG(adc, ss, OFS_SSFSTAT0) & ADC_SSFSTAT0_EMPTY))
+        (void)ADC_SS_REG(adc, ss, OFS_SSFIFO0);
+    ADC_REG(adc, OFS_OSTAT) = 1 << ss;               // clear overflow and underflow flags
+    ADC_REG(adc, OFS_USTAT) = 1 << ss;
+    ADC_REG(adc, OFS_ISC) = 1 << ss;
+    ADC_REG(adc, OFS_ACTSS) |= 1 << ss;
+}
+
+void disableAdcSequence(ADC adc, uint8_t ss)
+{
+    ADC_REG(adc, OFS_ACTSS) &= ~(1 << ss);
+}
+
+static uint8_t getAdcVector(ADC adc, uint8_t ss)
+{
+    return (adc == ADC0 ? INT_ADC0SS0 : INT_ADC1SS0) + ss;
+}
+
+// Run the sequencer isr at the end of every sequence
+void enableAdcInterrupt(ADC adc, uint8_t ss)
+{
+    ADC_REG(adc, OFS_ISC) = 1 << ss;
+    ADC_REG(adc, OFS_IM) |= 1 << ss;
+    enableNvicInterrupt(getAdcVector(adc, ss));
+}
+
+// Results are moved by uDMA channel getAdcDmaChannel, set up by the caller, and the
+// sequencer isr only runs when that transfer completes
+void enableAdcDma(ADC adc, uint8_t ss)
+{
+    ADC_REG(adc, OFS_IM) &= ~(1 << ss);
+    enableNvicInterrupt(getAdcVector(adc, ss));
+}
+
+void disableAdcInterrupt(ADC adc, uint8_t ss)
+{
+    disableNvicInterrupt(getAdcVector(adc, ss));
+    ADC_REG(adc, OFS_IM) &= ~(1 << ss);
+    ADC_REG(adc, OFS_ISC) = 1 << ss;
+}
+
+// Channel (encoding 0) requested by the sequencer FIFO
+uint8_t getAdcDmaChannel(ADC adc, uint8_t ss)
+{
+    return (adc == ADC0 ? 14 : 24) + ss;
+}
+
+uint32_t getAdcFifoAddress(ADC adc, uint8_t ss)
+{
+    return (uint32_t)adc + OFS_SSFIFO0 + ss * OFS_SS_STEP;
+}
+
+// Processor trigger for sequencers set to ADC_TRIGGER_PROCESSOR
+void startAdcSequence(ADC adc, uint8_t ss)
+{
+    ADC_REG(adc, OFS_PSSI) = 1 << ss;
+}
+
+bool isAdcSequenceDone(ADC adc, uint8_t ss)
+{
+    return ADC_REG(adc, OFS_RIS) & (1 << ss);
+}
+
+// Clear the sequence interrupt and read up to maxCount results in step order, returns the
+// number read, does not wait, so call it from the isr or once isAdcSequenceDone
+uint8_t readAdcSequence(ADC adc, uint8_t ss, uint16_t results[], uint8_t maxCount)
+{
+    uint8_t count = 0;
+    ADC_REG(adc, OFS_ISC) = 1 << ss;                 // clear interrupt flag
+    while (count < maxCount && !(ADC_SS_REG(adc, ss, OFS_SSFSTAT0) & ADC_SSFSTAT0_EMPTY))
+        results[count++] = ADC_SS_REG(adc, ss, OFS_SSFIFO0);
+    return count;
+}
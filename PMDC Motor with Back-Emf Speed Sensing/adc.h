@@ -0,0 +1,72 @@
+// ADC Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// ADC0 and ADC1, sample sequencers SS0-SS3 (8, 4, 4 and 1 steps)
+//   Each sequencer converts a list of analog inputs per trigger and ends with an interrupt
+//   Completion is collected by the sequencer isr, or by uDMA with the isr run once per transfer
+//   Analog pins are configured by the caller
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef ADC_H_
+#define ADC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Enum values set to the base address of each module
+typedef enum _ADC
+{
+    ADC0 = 0x40038000,
+    ADC1 = 0x40039000
+} ADC;
+
+// Enum values set to the ADCEMUX trigger field
+typedef enum _ADC_TRIGGER
+{
+    ADC_TRIGGER_PROCESSOR = 0x0,
+    ADC_TRIGGER_COMPARATOR0 = 0x1,
+    ADC_TRIGGER_COMPARATOR1 = 0x2,
+    ADC_TRIGGER_EXTERNAL = 0x4,
+    ADC_TRIGGER_TIMER = 0x5,                         // any timer with its TnOTE bit set
+    ADC_TRIGGER_PWM0 = 0x6,                          // PWM generator 0-3, module from selectAdcPwmModule
+    ADC_TRIGGER_PWM1 = 0x7,
+    ADC_TRIGGER_PWM2 = 0x8,
+    ADC_TRIGGER_PWM3 = 0x9,
+    ADC_TRIGGER_ALWAYS = 0xF
+} ADC_TRIGGER;
+
+#define ADC_MAX_STEPS 8
+#define ADC_MAX_LOG2_AVERAGE 6                       // 64x hardware averaging
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initAdc(ADC adc);
+bool setAdcLog2AverageCount(ADC adc, uint8_t log2AverageCount);
+bool setAdcSequence(ADC adc, uint8_t ss, const uint8_t inputs[], uint8_t count);
+void setAdcTrigger(ADC adc, uint8_t ss, ADC_TRIGGER trigger);
+void selectAdcPwmModule(ADC adc, uint8_t generator, uint8_t module);
+void enableAdcSequence(ADC adc, uint8_t ss);
+void disableAdcSequence(ADC adc, uint8_t ss);
+void enableAdcInterrupt(ADC adc, uint8_t ss);
+void enableAdcDma(ADC adc, uint8_t ss);
+void disableAdcInterrupt(ADC adc, uint8_t ss);
+uint8_t getAdcDmaChannel(ADC adc, uint8_t ss);
+uint32_t getAdcFifoAddress(ADC adc, uint8_t ss);
+void startAdcSequence(ADC adc, uint8_t ss);
+bool isAdcSequenceDone(ADC adc, uint8_t ss);
+uint8_t readAdcSequence(ADC adc, uint8_t ss, uint16_t results[], uint8_t maxCount);
+
+#endif
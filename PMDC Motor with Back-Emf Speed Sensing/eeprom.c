@@ -0,0 +1,126 @@
+// EEPROM Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// On-chip EEPROM, 2 KiB as 32 blocks of 16 words
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "eeprom.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static void waitEeprom(void)
+{
+    while (EEPROM_EEDONE_R & EEPROM_EEDONE_WORKING);
+}
+
+static bool isEepromRecoveryNeeded(void)
+{
+    return (EEPROM_EESUPP_R & (EEPROM_EESUPP_PRETRY | EEPROM_EESUPP_ERETRY)) != 0;
+}
+
+// Returns false if a write was interrupted by a power loss and could not be recovered
+bool initEeprom(void)
+{
+    SYSCTL_RCGCEEPROM_R = SYSCTL_RCGCEEPROM_R0;
+    _delay_cycles(6);
+    while (!(SYSCTL_PREEPROM_R & SYSCTL_PREEPROM_R0));
+    waitEeprom();
+    if (isEepromRecoveryNeeded())
+        return false;
+
+    // Reset so the controller finishes any copy left from an interrupted write
+    SYSCTL_SREEPROM_R = SYSCTL_SREEPROM_R0;
+    SYSCTL_SREEPROM_R = 0;
+    _delay_cycles(6);
+    while (!(SYSCTL_PREEPROM_R & SYSCTL_PREEPROM_R0));
+    waitEeprom();
+    return !isEepromRecoveryNeeded();
+}
+
+// Address in words, block = address / 16, offset = address % 16
+uint32_t readEeprom(uint16_t address)
+{
+    EEPROM_EEBLOCK_R = address >> 4;
+    EEPROM_EEOFFSET_R = address & 15;
+    return EEPROM_EERDWR_R;
+}
+
+// A write takes a few hundred microseconds, or several ms when the block has to be copied
+bool writeEeprom(uint16_t address, uint32_t data)
+{
+    EEPROM_EEBLOCK_R = address >> 4;
+    EEPROM_EEOFFSET_R = address & 15;
+    EEPROM_EERDWR_R = data;
+    waitEeprom();
+    return (EEPROM_EEDONE_R & EEPROM_EEDONE_NOPERM) == 0 && !isEepromRecoveryNeeded();
+}
+
+static uint32_t getRecordTag(uint8_t block, uint8_t count)
+{
+    return EEPROM_RECORD_TAG | ((uint32_t)block << 8) | count;
+}
+
+// Returns false, leaving data untouched, if the block does not hold a valid record of count words
+bool loadEepromRecord(uint8_t block, uint32_t data[], uint8_t count)
+{
+    uint32_t record[EEPROM_BLOCK_WORDS];
+    uint32_t sum = 0;
+    uint8_t i;
+
+    if (count > EEPROM_RECORD_WORDS)
+        return false;
+    for (i = 0; i < count + 2; i++)
+        record[i] = readEeprom(block * EEPROM_BLOCK_WORDS + i);
+    if (record[0] != getRecordTag(block, count))
+        return false;
+    for (i = 0; i <= count; i++)
+        sum += record[i];
+    if (record[count + 1] != ~sum)
+        return false;
+    for (i = 0; i < count; i++)
+        data[i] = record[i + 1];
+    return true;
+}
+
+// Words that already hold the value are not rewritten to save endurance
+bool saveEepromRecord(uint8_t block, const uint32_t data[], uint8_t count)
+{
+    uint32_t record[EEPROM_BLOCK_WORDS];
+    uint32_t sum = 0;
+    uint16_t address;
+    uint8_t i;
+    bool ok = true;
+
+    if (count > EEPROM_RECORD_WORDS)
+        return false;
+    record[0] = getRecordTag(block, count);
+    for (i = 0; i < count; i++)
+        record[i + 1] = data[i];
+    for (i = 0; i <= count; i++)
+        sum += record[i];
+    record[count + 1] = ~sum;
+
+    for (i = 0; i < count + 2 && ok; i++)
+    {
+        address = block * EEPROM_BLOCK_WORDS + i;
+        if (readEeprom(address) != record[i])
+            ok = writeEeprom(address, record[i]);
+    }
+    return ok;
+}
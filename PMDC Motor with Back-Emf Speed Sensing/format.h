@@ -0,0 +1,32 @@
+// Formatting Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Output is written through putcUart0
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef FORMAT_H_
+#define FORMAT_H_
+
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void putDecUart0(uint32_t value, uint8_t width);
+void putIntUart0(int32_t value, uint8_t width);
+void putHexUart0(uint32_t value, uint8_t digits);
+void putFixedUart0(int32_t value, uint8_t fractionDigits);
+
+#endif
@@ -0,0 +1,118 @@
+// Least-Squares Fit Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// None
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lsq_fit.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initLsqFit(LSQ_FIT *fit)
+{
+    uint8_t i;
+    fit->count = 0;
+    for (i = 0; i < 2 * LSQ_MAX_DEGREE + 1; i++)
+        fit->sumX[i] = 0;
+    for (i = 0; i < LSQ_MAX_DEGREE + 1; i++)
+        fit->sumXY[i] = 0;
+}
+
+void addLsqPoint(LSQ_FIT *fit, int32_t x, int32_t y)
+{
+    int64_t power = 1;
+    uint8_t i;
+    for (i = 0; i < 2 * LSQ_MAX_DEGREE + 1; i++)
+    {
+        fit->sumX[i] += power;
+        if (i <= LSQ_MAX_DEGREE)
+            fit->sumXY[i] += power * y;
+        power *= x;
+    }
+    fit->count++;
+}
+
+uint32_t getLsqCount(const LSQ_FIT *fit)
+{
+    return fit->count;
+}
+
+// Solve the normal equations for coefficients[0..degree], returns false if there are too
+// few distinct points
+// Done once per fit in double precision, with x scaled to about 0-1 so the sums of x^4
+// and x^0 stay within the same few orders of magnitude
+bool solveLsqFit(const LSQ_FIT *fit, uint8_t degree, double coefficients[])
+{
+    double a[LSQ_MAX_DEGREE + 1][LSQ_MAX_DEGREE + 2];
+    double scale[2 * LSQ_MAX_DEGREE + 1];
+    double factor;
+    double t;
+    uint8_t n = degree + 1;
+    uint8_t pivot;
+    uint8_t i, j, k;
+
+    if (degree > LSQ_MAX_DEGREE || fit->count < n)
+        return false;
+
+    scale[0] = 1;
+    for (i = 1; i < 2 * n - 1; i++)
+        scale[i] = scale[i - 1] / LSQ_X_SCALE;
+    for (i = 0; i < n; i++)
+    {
+        for (j = 0; j < n; j++)
+            a[i][j] = fit->sumX[i + j] * scale[i + j];
+        a[i][n] = fit->sumXY[i] * scale[i];
+    }
+
+    // Gaussian elimination with partial pivoting
+    for (k = 0; k < n; k++)
+    {
+        pivot = k;
+        for (i = k + 1; i < n; i++)
+        {
+            if ((a[i][k] < 0 ? -a[i][k] : a[i][k]) > (a[pivot][k] < 0 ? -a[pivot][k] : a[pivot][k]))
+                pivot = i;
+        }
+        if ((a[pivot][k] < 0 ? -a[pivot][k] : a[pivot][k]) < 1e-9 * fit->count)
+            return false;
+        for (j = k; j <= n; j++)
+        {
+            t = a[k][j];
+            a[k][j] = a[pivot][j];
+            a[pivot][j] = t;
+        }
+        for (i = k + 1; i < n; i++)
+        {
+            factor = a[i][k] / a[k][k];
+            for (j = k; j <= n; j++)
+                a[i][j] -= factor * a[k][j];
+        }
+    }
+    for (i = n; i-- > 0;)
+    {
+        t = a[i][n];
+        for (j = i + 1; j < n; j++)
+            t -= a[i][j] * coefficients[j];
+        coefficients[i] = t / a[i][i];
+    }
+
+    // Undo the x scaling
+    for (i = 0; i < n; i++)
+        coefficients[i] *= scale[i];
+    return true;
+}
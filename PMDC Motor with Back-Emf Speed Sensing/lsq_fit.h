@@ -0,0 +1,46 @@
+// Least-Squares Fit Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// None
+// Polynomial fit y = c0 + c1 x (+ c2 x^2) built one point at a time
+// Points only add to exact 64-bit sums of x^k and x^k y, so no sample list is kept and the
+// fit can be solved at any time; x is expected to be an adc count (0-4095)
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef LSQ_FIT_H_
+#define LSQ_FIT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LSQ_MAX_DEGREE 2
+#define LSQ_X_SCALE 4096.0                           // x range, used to condition the solve
+
+typedef struct _LSQ_FIT
+{
+    uint32_t count;
+    int64_t sumX[2 * LSQ_MAX_DEGREE + 1];            // sum of x^k, k = 0..2 * LSQ_MAX_DEGREE
+    int64_t sumXY[LSQ_MAX_DEGREE + 1];               // sum of x^k y, k = 0..LSQ_MAX_DEGREE
+} LSQ_FIT;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initLsqFit(LSQ_FIT *fit);
+void addLsqPoint(LSQ_FIT *fit, int32_t x, int32_t y);
+uint32_t getLsqCount(const LSQ_FIT *fit);
+bool solveLsqFit(const LSQ_FIT *fit, uint8_t degree, double coefficients[]);
+
+#endif
@@ -13,19 +13,32 @@
 // Device includes, defines, and assembler directives
 //-----------------------------------------------------------------------------
 #include <stdint.h>
-#include <stdio.h>
 #include <stdbool.h>
+#include <math.h>
+#ifdef BENCHMARK_FORMAT
+#include <stdio.h>
+#endif
 
 #include "wait.h"
 #include "clock.h"
 #include "uart0.h"
 #include "tm4c123gh6pm.h"
 #include "gpio.h"
-#include "adc0.h"
+#include "adc.h"
 #include "nvic.h"
+#include "format.h"
+#include "telemetry.h"
+#include "command.h"
+#include "eeprom.h"
+#include "freq_time.h"
+#include "pi.h"
+#include "relay_tune.h"
+#include "lsq_fit.h"
 
-//Analog AIN3/PE0
+//Analog AIN3/PE0 back-emf, AIN2/PE1 motor current (shunt amplifier output)
 #define AIN3_MASK 1
+#define AIN2_MASK 2
+#define BACK_EMF_SS 1
 
 // PortC masks PC6 SIGNAL_IN on PC6 (WT1CCP0)
 #define FREQ_IN_MASK 64
@@ -42,6 +55,49 @@
 #define PWM_MASK 128
 #define PWM_MOTOR PWM1_1_CMPB_R
 
+// Back-emf is sampled in a forced-off window started by the 50 Hz timer
+// PWM1 generator 1 triggers ADC0 SS1 when its count reaches CMPA, once per PWM period,
+// and the conversion that lands backEmfDelay after the motor turned off ends the window
+// SS1 converts back-emf then motor current, the current left at the sample shows whether
+// the winding has stopped conducting through the flyback diode by then
+#define BACK_EMF_RATE_HZ 50
+#define PWM_CLOCK_MHZ 40
+#define DEFAULT_BACK_EMF_DELAY_US 200
+#define MAX_BACK_EMF_DELAY_US 1000
+
+// Closed-loop speed control on TIMER2A, off until a speed is set
+// Gains are x1000: kp in pwm counts per rpm, ki in pwm counts per rpm-second
+#define DEFAULT_LOOP_RATE_HZ 1000
+#define MIN_LOOP_RATE_HZ 10
+#define MAX_LOOP_RATE_HZ 5000
+#define DEFAULT_KP 200
+#define DEFAULT_KI 1000
+#define DEFAULT_SLEW 2000                            // pwm counts per second
+#define SPEED_STEP_RPM 50
+#define PWM_MAX 1023
+
+// Relay auto-tune, the duty is switched this far either side of the present duty
+#define TUNE_DEFAULT_STEP 100
+#define TUNE_DEFAULT_HYSTERESIS_RPM 20
+#define TUNE_TIMEOUT_S 30
+
+// Back-emf calibration sweep, open loop from the first to the last duty
+// Each step waits CAL_MIN_SETTLE_US, then compares the tach rpm over successive gates until
+// two agree within CAL_STEADY_RPM (or CAL_MAX_SETTLE_US passes), and takes that gate's
+// tach rpm against the mean back-emf reading over it
+#define CAL_FIRST_PWM 256
+#define CAL_LAST_PWM 1023
+#define CAL_STEP_PWM 64
+#define CAL_MIN_SETTLE_US 500000
+#define CAL_MAX_SETTLE_US 10000000
+#define CAL_STEADY_RPM 10
+
+typedef enum _SPEED_FEEDBACK
+{
+    FEEDBACK_TACH,
+    FEEDBACK_BACK_EMF
+} SPEED_FEEDBACK;
+
 //-----------------------------------------------------------------------------
 // Global variables
 //-----------------------------------------------------------------------------
@@ -50,8 +106,47 @@ uint32_t frequency = 0;
 uint32_t time = 0;
 uint16_t rpm = 1;
 uint16_t rawAnalog = 0;
+uint16_t rawCurrent = 0;
 uint16_t backEmfRpm = 0;
 
+PI_CONTROLLER speedPi;
+SPEED_FEEDBACK speedFeedback = FEEDBACK_TACH;
+uint32_t speedLoopRate = DEFAULT_LOOP_RATE_HZ;
+uint32_t speedSlew = DEFAULT_SLEW;
+int32_t speedSetpoint = 0;
+bool speedLoopEnabled = false;
+
+RELAY_TUNE relayTune;
+bool autoTuning = false;
+uint32_t tuneBias = 0;
+bool tuneResumeLoop = false;
+
+// Forced-off window state, the triggers to skip are counted down by backEmfIsr
+uint32_t backEmfDelay = DEFAULT_BACK_EMF_DELAY_US;
+uint32_t backEmfPeriods = 0;
+volatile uint32_t backEmfTriggers = 0;
+volatile bool backEmfWindow = false;
+volatile bool backEmfUpdated = false;
+
+// Back-emf fit rpm = quadratic * analog^2 + slope * analog + intercept, quadratic scaled
+// by 1e9 and the others by 1e4
+// The defaults are the bench fit y = -0.9359x + 1821, a saved fit replaces them at boot
+int32_t backEmfQuadratic = 0;
+int32_t backEmfSlope = -9359;
+int32_t backEmfIntercept = 18210000;
+
+// Calibration sweep state
+LSQ_FIT emfFit;
+bool calibrating = false;
+uint8_t calDegree = 1;
+uint32_t calDuty = 0;
+uint32_t calRestoreDuty = 0;
+uint32_t calStepStart = 0;
+uint32_t calLastGate = 0;
+int32_t calLastRpm = -1;
+uint32_t calAnalogSum = 0;
+uint32_t calAnalogCount = 0;
+
 //-----------------------------------------------------------------------------
 // Subroutines
 //-----------------------------------------------------------------------------
@@ -86,7 +181,7 @@ void enablefiftyTimer(){
     TIMER3_CTL_R &= ~TIMER_CTL_TAEN;             // turn-off timer before reconfiguring
     TIMER3_CFG_R = TIMER_CFG_32_BIT_TIMER;       // configure as 32-bit timer (A+B)
     TIMER3_TAMR_R = TIMER_TAMR_TAMR_PERIOD;      // configure for periodic mode (count down)
-    TIMER3_TAILR_R = 800000;                   // set load value to 40e6 for 1 Hz interrupt rate
+    TIMER3_TAILR_R = 40000000 / BACK_EMF_RATE_HZ - 1;  // one window per back-emf sample
     TIMER3_IMR_R = TIMER_IMR_TATOIM;             // turn-on interrupts
     TIMER3_CTL_R |= TIMER_CTL_TAEN;              // turn-on timer
     //INT_TIMER3A
@@ -94,39 +189,257 @@ void enablefiftyTimer(){
     enablePinInterrupt(PORTB,2);
 }
 
-void enableCounterMode(){
-    // Configure Timer 1 as the time base
-    TIMER1_CTL_R &= ~TIMER_CTL_TAEN;                 // turn-off timer before reconfiguring
-    TIMER1_CFG_R = TIMER_CFG_32_BIT_TIMER;           // configure as 32-bit timer (A+B)
-    TIMER1_TAMR_R = TIMER_TAMR_TAMR_PERIOD;          // configure for periodic mode (count down)
-    TIMER1_TAILR_R = 40000000;                       // set load value to 40e6 for 1 Hz interrupt rate
-    TIMER1_IMR_R = TIMER_IMR_TATOIM;                 // turn-on interrupts
-    TIMER1_CTL_R |= TIMER_CTL_TAEN;                  // turn-on timer
-    NVIC_EN0_R |= 1 << (INT_TIMER1A-16);             // turn-on interrupt 37 (TIMER1A)
-
-    // Configure Wide Timer 1 as counter of external events on CCP0 pin
-    WTIMER1_CTL_R &= ~TIMER_CTL_TAEN;                // turn-off counter before reconfiguring
-    WTIMER1_CFG_R = 4;                               // configure as 32-bit counter (A only)
-    WTIMER1_TAMR_R = TIMER_TAMR_TAMR_CAP | TIMER_TAMR_TACDIR; // configure for edge count mode, count up
-    WTIMER1_CTL_R = 0;                               //
-    WTIMER1_IMR_R = 0;                               // turn-off interrupts
-    WTIMER1_TAV_R = 0;                               // zero counter for first period
-    WTIMER1_CTL_R |= TIMER_CTL_TAEN;                 // turn-on counter
+// Place the sample backEmfDelay us after the start of the first off period
+// The generator counts down from LOAD, so the offset into a period is LOAD - CMPA
+void setBackEmfDelay(uint32_t us){
+    uint32_t period = PWM1_1_LOAD_R + 1;
+    uint32_t clocks = us * PWM_CLOCK_MHZ;
+    backEmfDelay = us;
+    backEmfPeriods = clocks / period;
+    PWM1_1_CMPA_R = PWM1_1_LOAD_R - clocks % period;
 }
 
+// Start the forced-off window, the duty change takes effect at the next period
+// A trigger still ahead in the current (on) period is skipped as well
 void fiftyTimerIsr(){
     PWM_MOTOR = 0;
-    waitMicrosecond(200);
-    rawAnalog = readAdc0Ss3();
-    PWM_MOTOR = pwmVal;
+    backEmfWindow = true;
+    backEmfTriggers = backEmfPeriods;
+    if (PWM1_1_COUNT_R > PWM1_1_CMPA_R){
+        backEmfTriggers++;
+    }
+    PWM1_1_INTEN_R = PWM_1_INTEN_TRCMPAD;        // trigger the adc every period at CMPA
     TIMER3_ICR_R = TIMER_ICR_TATOCINT;           // clear interrupt flag
 }
 
-// Frequency counter service publishing latest frequency measurements every second
-void timer1Isr(){
-    frequency = WTIMER1_TAV_R;                   // read counter input
-    WTIMER1_TAV_R = 0;                           // reset counter for next period
-    TIMER1_ICR_R = TIMER_ICR_TATOCINT;           // clear interrupt flag
+// Collect each triggered conversion, the last one of the window is the back-emf sample
+void backEmfIsr(){
+    uint16_t samples[2];
+    readAdcSequence(ADC0, BACK_EMF_SS, samples, 2);
+    if (backEmfTriggers > 0){
+        backEmfTriggers--;
+        return;
+    }
+    PWM1_1_INTEN_R = 0;                          // stop triggering until the next window
+    rawAnalog = samples[0];
+    rawCurrent = samples[1];
+    backEmfUpdated = true;
+    PWM_MOTOR = pwmVal;
+    backEmfWindow = false;
+}
+
+// True once for each back-emf sample taken since the last call
+bool isBackEmfUpdated(){
+    bool result = backEmfUpdated;
+    backEmfUpdated = false;
+    return result;
+}
+
+// Change the duty, the back-emf isr restores it if a window is open
+void setMotorPwm(uint32_t value){
+    TIMER3_IMR_R = 0;                            // hold off both window interrupts
+    ADC0_IM_R &= ~ADC_IM_MASK1;
+    pwmVal = value;
+    if (!backEmfWindow){
+        PWM_MOTOR = pwmVal;
+    }
+    ADC0_IM_R |= ADC_IM_MASK1;
+    TIMER3_IMR_R = TIMER_IMR_TATOIM;
+}
+
+int32_t getTachRpm(){
+    return (getCounterFrequency() * 60) / 32;
+}
+
+int32_t getBackEmfRpm(){
+    int32_t x = rawAnalog;
+    return (backEmfIntercept + backEmfSlope * x + (int32_t)((int64_t)backEmfQuadratic * x * x / 100000)) / 10000;
+}
+
+// Keep the PI integral and slew scaled to the rate it is actually updated at
+void matchSpeedPiRate(uint32_t rate){
+    if (speedPi.rate != rate){
+        setPiRate(&speedPi, rate);
+        setPiSlew(&speedPi, speedSlew);
+    }
+}
+
+// Samples per second the speed loop sees from the back-emf, at most one per tick
+uint32_t getBackEmfLoopRate(){
+    return BACK_EMF_RATE_HZ < speedLoopRate ? BACK_EMF_RATE_HZ : speedLoopRate;
+}
+
+// One PI update per new back-emf sample (one per window) or per new tach measurement (one
+// per subgate), at most one per tick, so a held value is not integrated over and over,
+// or one relay step per new back-emf sample while auto-tuning
+void speedLoopIsr(){
+    uint32_t tachRate;
+    if (autoTuning){
+        if (isBackEmfUpdated()){
+            setMotorPwm(updateRelayTune(&relayTune, getBackEmfRpm()));
+        }
+    }
+    else if (speedFeedback == FEEDBACK_TACH){
+        if (isCounterUpdated()){
+            tachRate = FREQ_SUBGATES * 1000 / getCounterGate();
+            matchSpeedPiRate(tachRate < speedLoopRate ? tachRate : speedLoopRate);
+            setMotorPwm(updatePi(&speedPi, speedSetpoint - getTachRpm()));
+        }
+    }
+    else if (isBackEmfUpdated()){
+        matchSpeedPiRate(getBackEmfLoopRate());
+        setMotorPwm(updatePi(&speedPi, speedSetpoint - getBackEmfRpm()));
+    }
+    TIMER2_ICR_R = TIMER_ICR_TATOCINT;           // clear interrupt flag
+}
+
+void startSpeedTick(){
+    TIMER2_ICR_R = TIMER_ICR_TATOCINT;
+    TIMER2_IMR_R = TIMER_IMR_TATOIM;             // turn-on interrupts
+    TIMER2_CTL_R |= TIMER_CTL_TAEN;              // turn-on timer
+}
+
+void stopSpeedTick(){
+    TIMER2_CTL_R &= ~TIMER_CTL_TAEN;
+    TIMER2_IMR_R = 0;
+}
+
+void initSpeedLoop(){
+    initPi(&speedPi, 0, PWM_MAX, speedLoopRate);
+    setPiGains(&speedPi, DEFAULT_KP, DEFAULT_KI);
+    setPiSlew(&speedPi, speedSlew);
+
+    TIMER2_CTL_R &= ~TIMER_CTL_TAEN;             // turn-off timer before reconfiguring
+    TIMER2_CFG_R = TIMER_CFG_32_BIT_TIMER;       // configure as 32-bit timer (A+B)
+    TIMER2_TAMR_R = TIMER_TAMR_TAMR_PERIOD;      // configure for periodic mode (count down)
+    TIMER2_TAILR_R = 40000000 / speedLoopRate - 1;  // period is TAILR + 1 cycles
+    enableNvicInterrupt(INT_TIMER2A);
+}
+
+// Close the loop from the present duty so the motor does not jump
+void enableSpeedLoop(){
+    if (speedLoopEnabled){
+        return;
+    }
+    resetPi(&speedPi, pwmVal);
+    isCounterUpdated();                          // wait for a fresh measurement
+    isBackEmfUpdated();
+    startSpeedTick();
+    speedLoopEnabled = true;
+}
+
+void disableSpeedLoop(){
+    stopSpeedTick();
+    speedLoopEnabled = false;
+}
+
+// Gains, slew and rate are changed with the tick held off
+void setSpeedLoop(int32_t kp, int32_t ki, uint32_t slew, uint32_t rate){
+    TIMER2_IMR_R = 0;
+    speedLoopRate = rate;
+    speedSlew = slew;
+    TIMER2_TAILR_R = 40000000 / rate - 1;
+    setPiRate(&speedPi, rate);
+    setPiGains(&speedPi, kp, ki);
+    setPiSlew(&speedPi, slew);
+    if (speedLoopEnabled || autoTuning){
+        TIMER2_IMR_R = TIMER_IMR_TATOIM;
+    }
+}
+
+// Gains are saved with the feedback they were set for
+void loadSpeedGains(){
+    uint32_t record[3];
+    if (loadEepromRecord(EEPROM_BLOCK_SPEED_GAINS, record, 3)){
+        setPiGains(&speedPi, record[0], record[1]);
+        speedFeedback = record[2] == FEEDBACK_BACK_EMF ? FEEDBACK_BACK_EMF : FEEDBACK_TACH;
+    }
+}
+
+void saveSpeedGains(){
+    uint32_t record[3];
+    record[0] = speedPi.kp;
+    record[1] = speedPi.ki;
+    record[2] = speedFeedback;
+    if (!saveEepromRecord(EEPROM_BLOCK_SPEED_GAINS, record, 3) && getTelemetryMode() == TELEMETRY_TEXT){
+        putsUart0("EEPROM write failed\n");
+    }
+}
+
+// Relay step duties either side of the present duty around center rpm, the speed loop
+// is held off until the tune ends
+// The relay steps once per back-emf sample, so its period and timeout count samples
+void startAutoTune(int32_t center, int32_t step, int32_t hysteresis){
+    int32_t low = (int32_t)pwmVal - step;
+    int32_t high = (int32_t)pwmVal + step;
+    tuneBias = pwmVal;
+    tuneResumeLoop = speedLoopEnabled;
+    stopSpeedTick();
+    speedLoopEnabled = false;
+    initRelayTune(&relayTune, center, hysteresis, low < 0 ? 0 : low, high > PWM_MAX ? PWM_MAX : high,
+                  TUNE_TIMEOUT_S * getBackEmfLoopRate());
+    isBackEmfUpdated();                          // wait for a fresh sample
+    autoTuning = true;
+    startSpeedTick();
+}
+
+void stopAutoTune(){
+    if (!autoTuning){
+        return;
+    }
+    stopSpeedTick();
+    autoTuning = false;
+    setMotorPwm(tuneBias);
+    if (tuneResumeLoop){
+        enableSpeedLoop();
+    }
+}
+
+// Ziegler-Nichols PI from the limit cycle: Ku = 4d / (pi sqrt(a^2 - e^2)) for relay
+// amplitude d and hysteresis e, kp = 0.45 Ku, ki = 0.54 Ku / Tu
+// The relay identified the loop through the back-emf estimate, so the gains only suit
+// that feedback and the loop is switched to it (the tach adds far more lag)
+void finishAutoTune(){
+    float period = (float)getRelayTunePeriod(&relayTune) / getBackEmfLoopRate();
+    float amplitude = getRelayTuneAmplitude(&relayTune);
+    float step = (relayTune.high - relayTune.low) / 2.0f;
+    float swing = amplitude * amplitude - (float)relayTune.hysteresis * relayTune.hysteresis;
+    float ku;
+    bool ok = getRelayTuneState(&relayTune) == RELAY_TUNE_DONE && period > 0 && swing > 0;
+
+    stopAutoTune();
+    if (!ok){
+        if (getTelemetryMode() == TELEMETRY_TEXT){
+            putsUart0("Auto-tune failed, no limit cycle\n");
+        }
+        return;
+    }
+    ku = 4 * step / (3.14159265f * sqrtf(swing));
+    speedFeedback = FEEDBACK_BACK_EMF;
+    setSpeedLoop(0.45f * ku * PI_GAIN_SCALE, 0.54f * ku / period * PI_GAIN_SCALE, speedSlew, speedLoopRate);
+    saveSpeedGains();
+    if (getTelemetryMode() != TELEMETRY_TEXT){
+        return;
+    }
+    putsUart0("Tu: ");
+    putDecUart0(period * 1000, 0);
+    putsUart0(" (ms)  Amplitude: ");
+    putDecUart0(amplitude, 0);
+    putsUart0(" (rpm)  Kp: ");
+    putFixedUart0(speedPi.kp, 3);
+    putsUart0("  Ki: ");
+    putFixedUart0(speedPi.ki, 3);
+    putsUart0("\nFeedback switched to back-emf, the gains were tuned on it\n");
+}
+
+void enableBackEmfSampling(){
+    const uint8_t inputs[2] = {3, 2};
+    setBackEmfDelay(DEFAULT_BACK_EMF_DELAY_US);
+    setAdcSequence(ADC0, BACK_EMF_SS, inputs, 2);
+    selectAdcPwmModule(ADC0, 1, 1);
+    setAdcTrigger(ADC0, BACK_EMF_SS, ADC_TRIGGER_PWM1);
+    enableAdcInterrupt(ADC0, BACK_EMF_SS);
+    enableAdcSequence(ADC0, BACK_EMF_SS);
 }
 
 // Period timer service publishing latest time measurements every positive edge
@@ -136,6 +449,69 @@ void wideTimer1Isr(){
     WTIMER1_ICR_R = TIMER_ICR_CAECINT;           // clear interrupt flag
 }
 
+#ifdef BENCHMARK_FORMAT
+// SysTick cycles elapsed since start (24-bit down counter at the system clock)
+uint32_t elapsedCycles(uint32_t start){
+    return (start - NVIC_ST_CURRENT_R) & NVIC_ST_RELOAD_M;
+}
+
+// Compares the cost of queueing the status block with sprintf and with putDecUart0
+void benchmarkFormat(){
+    char str[10];
+    uint32_t start;
+    uint32_t sprintfCycles;
+    uint32_t formatCycles;
+
+    NVIC_ST_CTRL_R = 0;
+    NVIC_ST_RELOAD_R = NVIC_ST_RELOAD_M;
+    NVIC_ST_CURRENT_R = 0;
+    NVIC_ST_CTRL_R = NVIC_ST_CTRL_CLK_SRC | NVIC_ST_CTRL_ENABLE;
+
+    flushUart0();
+    start = NVIC_ST_CURRENT_R;
+    putsUart0("Frequency: ");
+    sprintf(str, "%7lu", frequency);
+    putsUart0(str);
+    putsUart0(" (Hz)\nRPM: ");
+    sprintf(str, "%7lu", (frequency * 60) / 32);
+    putsUart0(str);
+    putsUart0("\nBack-emf RPM: ");
+    sprintf(str, "%7lu", (uint32_t)(uint16_t)(-0.9359 * rawAnalog + 1821));
+    putsUart0(str);
+    putsUart0("\nAnalog: ");
+    sprintf(str, "%7lu", (uint32_t)rawAnalog);
+    putsUart0(str);
+    putsUart0("\nPWM: ");
+    sprintf(str, "%7lu", pwmVal);
+    putsUart0(str);
+    putsUart0("\n\n");
+    sprintfCycles = elapsedCycles(start);
+
+    flushUart0();
+    start = NVIC_ST_CURRENT_R;
+    putsUart0("Frequency: ");
+    putDecUart0(frequency, 7);
+    putsUart0(" (Hz)\nRPM: ");
+    putDecUart0((frequency * 60) / 32, 7);
+    putsUart0("\nBack-emf RPM: ");
+    putDecUart0((uint16_t)((18210000 - 9359 * (int32_t)rawAnalog) / 10000), 7);
+    putsUart0("\nAnalog: ");
+    putDecUart0(rawAnalog, 7);
+    putsUart0("\nPWM: ");
+    putDecUart0(pwmVal, 7);
+    putsUart0("\n\n");
+    formatCycles = elapsedCycles(start);
+
+    flushUart0();
+    putsUart0("sprintf cycles: ");
+    putDecUart0(sprintfCycles, 7);
+    putsUart0("\nformat cycles:  ");
+    putDecUart0(formatCycles, 7);
+    putsUart0("\n\n");
+    NVIC_ST_CTRL_R = 0;
+}
+#endif
+
 // Initialize Hardware
 void initHw(){
     // Initialize system clock to 40 MHz
@@ -148,7 +524,7 @@ void initHw(){
 
     SYSCTL_RCGCWTIMER_R |= SYSCTL_RCGCWTIMER_R1;
     SYSCTL_RCGCWTIMER_R |= SYSCTL_RCGCWTIMER_R2;
-    initAdc0Ss3();
+    initAdc(ADC0);
     initUart0();
 
     enablePort(PORTB);
@@ -164,12 +540,16 @@ void initHw(){
     GPIO_PORTE_DEN_R &= ~AIN3_MASK;                  // turn off digital operation on pin PE0
     GPIO_PORTE_AMSEL_R |= AIN3_MASK;                 // turn on analog operation on pin PE0
 
+    // Configure AIN2 as an analog input
+    GPIO_PORTE_AFSEL_R |= AIN2_MASK;                 // select alternative functions for AN2 (PE1)
+    GPIO_PORTE_DEN_R &= ~AIN2_MASK;                  // turn off digital operation on pin PE1
+    GPIO_PORTE_AMSEL_R |= AIN2_MASK;                 // turn on analog operation on pin PE1
+
     // Setup UART0 baud rate
     setUart0BaudRate(115200, 40e6);
 
-    // Use AIN3 input with N=4 hardware sampling
-    setAdc0Ss3Mux(3);
-    setAdc0Ss3Log2AverageCount(64);
+    // N=4 hardware sampling, 4 us per input keeps both samples close to the window point
+    setAdcLog2AverageCount(ADC0, 2);
 
     // Configure pushbutton pins
     setPinCommitControl(SW2);
@@ -193,62 +573,473 @@ void initHw(){
     GPIO_PORTB_DEN_R |= FIFTY_TIME;                // enable bit 6 for digital input
 }
 
+// Console commands, dispatched through the hashed table in command.c
+void binaryCommand(const COMMAND_ARGS *args){
+    setTelemetryMode(TELEMETRY_BINARY);
+}
+
+void textCommand(const COMMAND_ARGS *args){
+    setTelemetryMode(TELEMETRY_TEXT);
+}
+
+// pwm VALUE runs the motor open loop at a fixed duty
+void pwmCommand(const COMMAND_ARGS *args){
+    int32_t value = args->integer[0];
+    calibrating = false;
+    stopAutoTune();
+    disableSpeedLoop();
+    if (value < 0){
+        value = 0;
+    }
+    if (value > PWM_MAX){
+        value = PWM_MAX;
+    }
+    setMotorPwm(value);
+}
+
+// speed RPM closes the speed loop at RPM, speed alone shows the loop
+// Replies are text only, in binary mode they would corrupt the telemetry stream
+void speedCommand(const COMMAND_ARGS *args){
+    if (args->count == 1){
+        calibrating = false;
+        stopAutoTune();
+        speedSetpoint = args->integer[0] < 0 ? 0 : args->integer[0];
+        enableSpeedLoop();
+    }
+    if (getTelemetryMode() != TELEMETRY_TEXT){
+        return;
+    }
+    putsUart0("Speed loop: ");
+    if (speedLoopEnabled){
+        putDecUart0(speedSetpoint, 0);
+        putsUart0(" (rpm) from ");
+        putsUart0(speedFeedback == FEEDBACK_TACH ? "tach\n" : "back-emf\n");
+    }
+    else{
+        putsUart0("off\n");
+    }
+}
+
+// feedback tach | feedback emf selects the speed estimate the loop closes on
+void feedbackCommand(const COMMAND_ARGS *args){
+    if (strCmp(args->string[0], "tach") == 0){
+        speedFeedback = FEEDBACK_TACH;
+    }
+    else if (strCmp(args->string[0], "emf") == 0){
+        speedFeedback = FEEDBACK_BACK_EMF;
+    }
+    else if (getTelemetryMode() == TELEMETRY_TEXT){
+        putsUart0("Feedback is tach or emf\n");
+    }
+}
+
+// pi KP KI [SLEW [RATE]] sets the gains (x1000), slew (counts/s) and loop rate (Hz),
+// pi alone shows them
+// On tach feedback the loop updates once per counter subgate, so shorten the gate for a
+// faster loop, on back-emf feedback it updates once per 50 Hz sample window
+void piCommand(const COMMAND_ARGS *args){
+    uint32_t slew = speedSlew;
+    uint32_t rate = speedLoopRate;
+    bool text = getTelemetryMode() == TELEMETRY_TEXT;
+    if (args->count == 1){
+        if (text){
+            putCommandStatusUart0(COMMAND_MISSING_ARGUMENT);
+        }
+        return;
+    }
+    if (args->count >= 2){
+        if (args->count >= 3 && args->integer[2] > 0){
+            slew = args->integer[2];
+        }
+        if (args->count >= 4){
+            if (args->integer[3] < MIN_LOOP_RATE_HZ || args->integer[3] > MAX_LOOP_RATE_HZ){
+                if (text){
+                    putsUart0("Rate is 10 to 5000 Hz\n");
+                }
+                return;
+            }
+            rate = args->integer[3];
+        }
+        setSpeedLoop(args->integer[0], args->integer[1], slew, rate);
+        saveSpeedGains();
+    }
+    if (!text){
+        return;
+    }
+    putsUart0("Kp: ");
+    putFixedUart0(speedPi.kp, 3);
+    putsUart0("  Ki: ");
+    putFixedUart0(speedPi.ki, 3);
+    putsUart0("  Slew: ");
+    putDecUart0(speedSlew, 0);
+    putsUart0(" (/s)  Rate: ");
+    putDecUart0(speedLoopRate, 0);
+    putsUart0(" (Hz)\n");
+}
+
+// window US sets the delay from motor off to the back-emf sample, window alone shows it
+void windowCommand(const COMMAND_ARGS *args){
+    bool text = getTelemetryMode() == TELEMETRY_TEXT;
+    if (args->count == 1){
+        if (args->integer[0] > 0 && args->integer[0] <= MAX_BACK_EMF_DELAY_US){
+            setBackEmfDelay(args->integer[0]);
+        }
+        else if (text){
+            putsUart0("Window is 1 to 1000 us\n");
+        }
+    }
+    if (!text){
+        return;
+    }
+    putsUart0("Back-emf sample: ");
+    putDecUart0(backEmfDelay, 0);
+    putsUart0(" (us) after motor off\n");
+}
+
+// Fits saved before the quadratic term was added have two words
+void loadBackEmfFit(){
+    uint32_t record[3];
+    if (loadEepromRecord(EEPROM_BLOCK_BACK_EMF_FIT, record, 3)){
+        backEmfQuadratic = record[2];
+    }
+    else if (!loadEepromRecord(EEPROM_BLOCK_BACK_EMF_FIT, record, 2)){
+        return;
+    }
+    backEmfSlope = record[0];
+    backEmfIntercept = record[1];
+}
+
+void saveBackEmfFit(){
+    uint32_t record[3];
+    record[0] = backEmfSlope;
+    record[1] = backEmfIntercept;
+    record[2] = backEmfQuadratic;
+    if (!saveEepromRecord(EEPROM_BLOCK_BACK_EMF_FIT, record, 3) && getTelemetryMode() == TELEMETRY_TEXT){
+        putsUart0("EEPROM write failed\n");
+    }
+}
+
+// Report the fit as text, or as a telemetry record in binary mode
+void putBackEmfFit(){
+    int32_t fit[3];
+    fit[0] = backEmfQuadratic;
+    fit[1] = backEmfSlope;
+    fit[2] = backEmfIntercept;
+    sendTelemetry(TELEMETRY_BACK_EMF_FIT, TELEMETRY_I32, fit, 3);
+    if (getTelemetryMode() != TELEMETRY_TEXT){
+        return;
+    }
+    putsUart0("Back-emf fit: ");
+    if (backEmfQuadratic != 0){
+        putFixedUart0(backEmfQuadratic, 9);
+        putsUart0(" * analog^2 + ");
+    }
+    putFixedUart0(backEmfSlope, 4);
+    putsUart0(" * analog + ");
+    putFixedUart0(backEmfIntercept, 4);
+    putsUart0("\n");
+}
+
+// Sweep the duty open loop, the speed loop and auto-tune are stopped first
+void startCalibration(uint8_t degree){
+    stopAutoTune();
+    disableSpeedLoop();
+    initLsqFit(&emfFit);
+    calDegree = degree;
+    calRestoreDuty = pwmVal;
+    calDuty = CAL_FIRST_PWM;
+    setMotorPwm(calDuty);
+    calStepStart = getTelemetryTimestamp();
+    calLastGate = calStepStart;
+    calLastRpm = -1;
+    calAnalogSum = 0;
+    calAnalogCount = 0;
+    calibrating = true;
+}
+
+// Solve the fit and apply it, the previous fit is kept if the sweep had too few points
+void finishCalibration(){
+    double c[LSQ_MAX_DEGREE + 1];
+    calibrating = false;
+    setMotorPwm(calRestoreDuty);
+    if (!solveLsqFit(&emfFit, calDegree, c)){
+        if (getTelemetryMode() == TELEMETRY_TEXT){
+            putsUart0("Calibration failed, too few points\n");
+        }
+        return;
+    }
+    backEmfIntercept = c[0] * 1e4;
+    backEmfSlope = c[1] * 1e4;
+    backEmfQuadratic = calDegree == 2 ? c[2] * 1e9 : 0;
+    saveBackEmfFit();
+    putBackEmfFit();
+}
+
+// Called from the main loop, advances the sweep once the speed is steady
+void updateCalibration(){
+    uint32_t now = getTelemetryTimestamp();
+    int32_t tachRpm;
+    int32_t point[3];
+
+    if (now - calStepStart < CAL_MIN_SETTLE_US){
+        return;
+    }
+    calAnalogSum += rawAnalog;
+    calAnalogCount++;
+    if (now - calLastGate < getCounterGate() * 1000){
+        return;
+    }
+
+    // One full gate since the last check
+    tachRpm = getTachRpm();
+    calLastGate = now;
+    if ((calLastRpm < 0 || tachRpm - calLastRpm > CAL_STEADY_RPM || calLastRpm - tachRpm > CAL_STEADY_RPM)
+        && now - calStepStart < CAL_MAX_SETTLE_US){
+        calLastRpm = tachRpm;
+        calAnalogSum = 0;
+        calAnalogCount = 0;
+        return;
+    }
+
+    // A stalled motor has no back-emf to calibrate against
+    if (tachRpm > 0){
+        point[0] = calDuty;
+        point[1] = tachRpm;
+        point[2] = calAnalogSum / calAnalogCount;
+        addLsqPoint(&emfFit, point[2], tachRpm);
+        sendTelemetry(TELEMETRY_BACK_EMF_CAL_POINT, TELEMETRY_I32, point, 3);
+        if (getTelemetryMode() == TELEMETRY_TEXT){
+            putsUart0("PWM: ");
+            putDecUart0(calDuty, 4);
+            putsUart0("  RPM: ");
+            putDecUart0(tachRpm, 5);
+            putsUart0("  Analog: ");
+            putDecUart0(point[2], 4);
+            putsUart0("\n");
+        }
+    }
+
+    calDuty += CAL_STEP_PWM;
+    if (calDuty > CAL_LAST_PWM){
+        finishCalibration();
+        return;
+    }
+    setMotorPwm(calDuty);
+    calStepStart = now;
+    calLastRpm = -1;
+    calAnalogSum = 0;
+    calAnalogCount = 0;
+}
+
+// calibrate [linear|quadratic] sweeps the duty and fits back-emf rpm to the tach
+void calibrateCommand(const COMMAND_ARGS *args){
+    uint8_t degree = 1;
+    bool text = getTelemetryMode() == TELEMETRY_TEXT;
+    if (calibrating){
+        if (text){
+            putsUart0("Calibration running\n");
+        }
+        return;
+    }
+    if (args->count == 1){
+        if (strCmp(args->string[0], "quadratic") == 0){
+            degree = 2;
+        }
+        else if (strCmp(args->string[0], "linear") != 0){
+            if (text){
+                putsUart0("Fit is linear or quadratic\n");
+            }
+            return;
+        }
+    }
+    startCalibration(degree);
+}
+
+// emf SLOPE INTERCEPT [QUADRATIC] (scaled by 1e4, quadratic by 1e9) saves a new fit,
+// emf alone shows the current one
+void emfCommand(const COMMAND_ARGS *args){
+    if (args->count == 1){
+        if (getTelemetryMode() == TELEMETRY_TEXT){
+            putCommandStatusUart0(COMMAND_MISSING_ARGUMENT);
+        }
+        return;
+    }
+    if (args->count >= 2){
+        backEmfSlope = args->integer[0];
+        backEmfIntercept = args->integer[1];
+        backEmfQuadratic = args->count == 3 ? args->integer[2] : 0;
+        saveBackEmfFit();
+    }
+    putBackEmfFit();
+}
+
+// gate MS sets the speed counter gate, gate alone shows it
+void gateCommand(const COMMAND_ARGS *args){
+    bool text = getTelemetryMode() == TELEMETRY_TEXT;
+    if (args->count == 1 && !setCounterGate(args->integer[0]) && text){
+        putsUart0("Gate is 1 to 1000 ms\n");
+    }
+    if (!text){
+        return;
+    }
+    putsUart0("Gate: ");
+    putDecUart0(getCounterGate(), 0);
+    putsUart0(" (ms)\n");
+}
+
+// autotune [STEP [HYSTERESIS]] relays the duty STEP counts either side of the present duty
+// around the setpoint (or the present speed when open loop), then sets and saves the gains
+void autotuneCommand(const COMMAND_ARGS *args){
+    int32_t step = TUNE_DEFAULT_STEP;
+    int32_t hysteresis = TUNE_DEFAULT_HYSTERESIS_RPM;
+    if (args->count >= 1 && args->integer[0] > 0){
+        step = args->integer[0];
+    }
+    if (args->count >= 2 && args->integer[1] >= 0){
+        hysteresis = args->integer[1];
+    }
+    if (autoTuning || calibrating){
+        if (getTelemetryMode() == TELEMETRY_TEXT){
+            putsUart0("Auto-tune or calibration running\n");
+        }
+        return;
+    }
+    startAutoTune(speedLoopEnabled ? speedSetpoint : getBackEmfRpm(), step, hysteresis);
+}
+
+const COMMAND commands[] =
+{
+    {"binary", 0, "", binaryCommand},
+    {"text", 0, "", textCommand},
+    {"pwm", 1, "n", pwmCommand},
+    {"emf", 0, "nnn", emfCommand},
+    {"calibrate", 0, "a", calibrateCommand},
+    {"gate", 0, "n", gateCommand},
+    {"window", 0, "n", windowCommand},
+    {"speed", 0, "n", speedCommand},
+    {"feedback", 1, "a", feedbackCommand},
+    {"pi", 0, "nnnn", piCommand},
+    {"autotune", 0, "nn", autotuneCommand}
+};
+
+void processCommand(USER_DATA *data){
+    COMMAND_STATUS status = runCommand(data);
+    if (getTelemetryMode() == TELEMETRY_TEXT){
+        putCommandStatusUart0(status);
+    }
+}
+
 int main(void){
+    USER_DATA data;
+
     initHw();
     initPWM();
     enableCounterMode();
+    enableBackEmfSampling();
     enablefiftyTimer();
+    initSpeedLoop();
 
     // Setup UART0 baud rate
     setUart0BaudRate(115200, 40e6);
     pwmVal = PWM_MOTOR;
+    initTelemetry();
+    startUart0LineInput();
+    if (!initCommands(commands, sizeof(commands) / sizeof(commands[0]))){
+        putsUart0("Command table init failed\n");
+    }
+    if (initEeprom()){
+        loadBackEmfFit();
+        loadSpeedGains();
+    }
+
+#ifdef BENCHMARK_FORMAT
+    benchmarkFormat();
+#endif
 
     // Endless loop performing multiple tasks
-    char str[10];
     while (true){
         // R(Vin) = floor(Vin/3.3V * 4096) -> Vin(R) ~= 3.3V * ((R+0.5) / 4096)
         // display freq value/ backemf derived rpm/ pwm %
-        if (pwmVal >= 1024){
-            pwmVal = 0;
+        if (autoTuning && getRelayTuneState(&relayTune) != RELAY_TUNE_RUNNING){
+            finishAutoTune();
+        }
+        if (calibrating){
+            updateCalibration();
         }
 
-        if(!getPinValue(SW2) && pwmVal <= 1024){
-            pwmVal += 32;
-            PWM_MOTOR = pwmVal;
+        // The switches step the duty open loop, or the setpoint when the loop is closed,
+        // and are ignored while auto-tuning or calibrating
+        if (speedLoopEnabled){
+            if (!getPinValue(SW2)){
+                speedSetpoint += SPEED_STEP_RPM;
+            }
+            if (!getPinValue(SW1) && speedSetpoint >= SPEED_STEP_RPM){
+                speedSetpoint -= SPEED_STEP_RPM;
+            }
         }
+        else if (!autoTuning && !calibrating){
+            if (pwmVal >= 1024){
+                setMotorPwm(0);
+            }
 
-        if (!getPinValue(SW1) && pwmVal <= 1024){
-            pwmVal -= 32;
-            PWM_MOTOR = pwmVal;
+            if(!getPinValue(SW2) && pwmVal <= 1024){
+                setMotorPwm(pwmVal + 32);
+            }
+
+            if (!getPinValue(SW1) && pwmVal <= 1024){
+                setMotorPwm(pwmVal - 32);
+            }
         }
 
-        putsUart0("Frequency: ");
-        sprintf(str, "%7lu", frequency);
-        putsUart0(str);
-        putsUart0(" (Hz)\n");
+        frequency = getCounterFrequency();
+        rpm = getTachRpm();
+
+        backEmfRpm = getBackEmfRpm();
 
-        putsUart0("RPM: ");
-        rpm = ((frequency * 60) / 32);
-        sprintf(str, "%7lu", rpm);
-        putsUart0(str);
-        putsUart0("\n");
+        if (getUart0Line(&data)){
+            processCommand(&data);
+        }
+        if (getTelemetryMode() == TELEMETRY_TEXT){
+            putsUart0("Frequency: ");
+            putDecUart0(frequency, 7);
+            putsUart0(" (Hz)\n");
 
-        // y = -0.9359x + 1821.8
-        putsUart0("Back-emf RPM: ");
-        backEmfRpm = -0.9359 * rawAnalog + 1821;
-        sprintf(str, "%7lu", backEmfRpm);
-        putsUart0(str);
-        putsUart0("\n");
+            putsUart0("RPM: ");
+            putDecUart0(rpm, 7);
+            putsUart0("\n");
 
-        putsUart0("Analog: ");
-        sprintf(str, "%7lu", rawAnalog);
-        putsUart0(str);
-        putsUart0("\n");
+            putsUart0("Back-emf RPM: ");
+            putDecUart0(backEmfRpm, 7);
+            putsUart0("\n");
 
-        putsUart0("PWM: ");
-        sprintf(str, "%7lu", pwmVal);
-        putsUart0(str);
-        putsUart0("\n\n");
+            putsUart0("Analog: ");
+            putDecUart0(rawAnalog, 7);
+            putsUart0("\n");
+
+            putsUart0("Current: ");
+            putDecUart0(rawCurrent, 7);
+            putsUart0("\n");
+
+            putsUart0("PWM: ");
+            putDecUart0(pwmVal, 7);
+            putsUart0("\n");
+
+            if (speedLoopEnabled){
+                putsUart0("Setpoint: ");
+                putDecUart0(speedSetpoint, 7);
+                putsUart0("\n");
+            }
+            putsUart0("\n");
+        }
+        sendTelemetry(TELEMETRY_FREQUENCY, TELEMETRY_U32, &frequency, 1);
+        sendTelemetry(TELEMETRY_RPM, TELEMETRY_U16, &rpm, 1);
+        sendTelemetry(TELEMETRY_BACK_EMF_RPM, TELEMETRY_U16, &backEmfRpm, 1);
+        sendTelemetry(TELEMETRY_BACK_EMF_RAW, TELEMETRY_U16, &rawAnalog, 1);
+        sendTelemetry(TELEMETRY_MOTOR_CURRENT_RAW, TELEMETRY_U16, &rawCurrent, 1);
+        sendTelemetry(TELEMETRY_PWM, TELEMETRY_U32, &pwmVal, 1);
+        if (speedLoopEnabled){
+            sendTelemetry(TELEMETRY_SPEED_SETPOINT, TELEMETRY_I32, &speedSetpoint, 1);
+        }
         waitMicrosecond(50000);
     }
 }
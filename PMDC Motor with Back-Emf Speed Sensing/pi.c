@@ -0,0 +1,98 @@
+// PI Controller Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// None
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pi.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Zero gains and no slew limit, the output starts at outputMin
+void initPi(PI_CONTROLLER *pi, int32_t outputMin, int32_t outputMax, uint32_t rate)
+{
+    pi->kp = 0;
+    pi->ki = 0;
+    pi->rate = rate;
+    pi->outputMin = outputMin;
+    pi->outputMax = outputMax;
+    pi->slew = outputMax - outputMin;
+    resetPi(pi, outputMin);
+}
+
+void setPiGains(PI_CONTROLLER *pi, int32_t kp, int32_t ki)
+{
+    pi->kp = kp;
+    pi->ki = ki;
+}
+
+// The integral is rescaled so its output term is unchanged
+void setPiRate(PI_CONTROLLER *pi, uint32_t rate)
+{
+    pi->integral = pi->integral * rate / pi->rate;
+    pi->rate = rate;
+}
+
+// Output change limit in output units per second, at least one unit per update
+void setPiSlew(PI_CONTROLLER *pi, uint32_t perSecond)
+{
+    pi->slew = perSecond / pi->rate;
+    if (pi->slew < 1)
+        pi->slew = 1;
+}
+
+// Start from output with zero error, so closing the loop does not bump the output
+void resetPi(PI_CONTROLLER *pi, int32_t output)
+{
+    if (output < pi->outputMin)
+        output = pi->outputMin;
+    if (output > pi->outputMax)
+        output = pi->outputMax;
+    pi->output = output;
+    pi->integral = (int64_t)output * PI_GAIN_SCALE * pi->rate;
+}
+
+// One update, returns the new output
+int32_t updatePi(PI_CONTROLLER *pi, int32_t error)
+{
+    int64_t scale = (int64_t)PI_GAIN_SCALE * pi->rate;
+    int64_t integral = pi->integral + (int64_t)pi->ki * error;
+    int64_t target = (int64_t)pi->kp * error / PI_GAIN_SCALE + integral / scale;
+    int32_t output = target;
+
+    if (target > pi->outputMax)
+        output = pi->outputMax;
+    if (target < pi->outputMin)
+        output = pi->outputMin;
+    if (output > pi->output + pi->slew)
+        output = pi->output + pi->slew;
+    if (output < pi->output - pi->slew)
+        output = pi->output - pi->slew;
+
+    // Keep integrating only when the output is free or the error pulls it off the limit
+    if (output == target || (output < target && error < 0) || (output > target && error > 0))
+    {
+        if (integral > (int64_t)pi->outputMax * scale)
+            integral = (int64_t)pi->outputMax * scale;
+        if (integral < (int64_t)pi->outputMin * scale)
+            integral = (int64_t)pi->outputMin * scale;
+        pi->integral = integral;
+    }
+    pi->output = output;
+    return output;
+}
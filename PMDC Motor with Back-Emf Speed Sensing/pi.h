@@ -0,0 +1,52 @@
+// PI Controller Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// None, updated at a fixed rate by the caller (typically from a timer isr)
+// Integer PI with gains scaled by PI_GAIN_SCALE, clamped and slew limited output, and
+// conditional integration so the integral does not wind up while the output is limited
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef PI_H_
+#define PI_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PI_GAIN_SCALE 1000
+
+typedef struct _PI_CONTROLLER
+{
+    int32_t kp;                                      // output per unit error, x PI_GAIN_SCALE
+    int32_t ki;                                      // output per unit error-second, x PI_GAIN_SCALE
+    uint32_t rate;                                   // updates per second
+    int32_t outputMin;
+    int32_t outputMax;
+    int32_t slew;                                    // largest output change per update
+    int64_t integral;                                // ki * error summed, output term is
+                                                     // integral / (PI_GAIN_SCALE * rate)
+    int32_t output;
+} PI_CONTROLLER;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initPi(PI_CONTROLLER *pi, int32_t outputMin, int32_t outputMax, uint32_t rate);
+void setPiGains(PI_CONTROLLER *pi, int32_t kp, int32_t ki);
+void setPiRate(PI_CONTROLLER *pi, uint32_t rate);
+void setPiSlew(PI_CONTROLLER *pi, uint32_t perSecond);
+void resetPi(PI_CONTROLLER *pi, int32_t output);
+int32_t updatePi(PI_CONTROLLER *pi, int32_t error);
+
+#endif
@@ -0,0 +1,100 @@
+// Relay Auto-Tune Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// None
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "relay_tune.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Start with the output high, timeout is in updates
+void initRelayTune(RELAY_TUNE *tune, int32_t center, int32_t hysteresis, int32_t low, int32_t high,
+                   uint32_t timeout)
+{
+    tune->center = center;
+    tune->hysteresis = hysteresis;
+    tune->low = low;
+    tune->high = high;
+    tune->on = true;
+    tune->ticks = 0;
+    tune->timeout = timeout;
+    tune->firstRise = 0;
+    tune->lastRise = 0;
+    tune->cycles = 0;
+    tune->minimum = center;
+    tune->maximum = center;
+    tune->state = RELAY_TUNE_RUNNING;
+}
+
+// One update, returns the relay output
+int32_t updateRelayTune(RELAY_TUNE *tune, int32_t measured)
+{
+    if (tune->state != RELAY_TUNE_RUNNING)
+        return tune->on ? tune->high : tune->low;
+
+    tune->ticks++;
+    if (tune->ticks >= tune->timeout)
+        tune->state = RELAY_TUNE_TIMEOUT;
+
+    // Peaks are only taken once the limit cycle has settled
+    if (tune->cycles > RELAY_SETTLE_CYCLES)
+    {
+        if (measured < tune->minimum)
+            tune->minimum = measured;
+        if (measured > tune->maximum)
+            tune->maximum = measured;
+    }
+
+    if (tune->on && measured > tune->center + tune->hysteresis)
+    {
+        tune->on = false;
+    }
+    else if (!tune->on && measured < tune->center - tune->hysteresis)
+    {
+        tune->on = true;
+        tune->cycles++;
+        if (tune->cycles == RELAY_SETTLE_CYCLES + 1)
+        {
+            tune->firstRise = tune->ticks;
+            tune->minimum = measured;
+            tune->maximum = measured;
+        }
+        tune->lastRise = tune->ticks;
+        if (tune->cycles == RELAY_SETTLE_CYCLES + 1 + RELAY_MEASURE_CYCLES)
+            tune->state = RELAY_TUNE_DONE;
+    }
+    return tune->on ? tune->high : tune->low;
+}
+
+RELAY_TUNE_STATE getRelayTuneState(const RELAY_TUNE *tune)
+{
+    return tune->state;
+}
+
+// Mean oscillation period in updates
+uint32_t getRelayTunePeriod(const RELAY_TUNE *tune)
+{
+    return (tune->lastRise - tune->firstRise) / RELAY_MEASURE_CYCLES;
+}
+
+// Half of the peak to peak swing over the timed cycles
+int32_t getRelayTuneAmplitude(const RELAY_TUNE *tune)
+{
+    return (tune->maximum - tune->minimum) / 2;
+}
@@ -0,0 +1,65 @@
+// Relay Auto-Tune Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// None, updated at a fixed rate by the caller with the measured process value
+// The output is switched between low and high as a relay with hysteresis around center,
+// which settles into a limit cycle at the ultimate period of the process
+// After RELAY_SETTLE_CYCLES, RELAY_MEASURE_CYCLES are timed and their peak to peak taken
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef RELAY_TUNE_H_
+#define RELAY_TUNE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define RELAY_SETTLE_CYCLES 2
+#define RELAY_MEASURE_CYCLES 4
+
+typedef enum _RELAY_TUNE_STATE
+{
+    RELAY_TUNE_RUNNING,
+    RELAY_TUNE_DONE,
+    RELAY_TUNE_TIMEOUT
+} RELAY_TUNE_STATE;
+
+typedef struct _RELAY_TUNE
+{
+    int32_t center;
+    int32_t hysteresis;
+    int32_t low;
+    int32_t high;
+    bool on;                                         // output is high
+    uint32_t ticks;                                  // updates since the start
+    uint32_t timeout;
+    uint32_t firstRise;                              // tick of the first timed rising switch
+    uint32_t lastRise;
+    uint8_t cycles;                                  // rising switches seen
+    int32_t minimum;
+    int32_t maximum;
+    RELAY_TUNE_STATE state;
+} RELAY_TUNE;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initRelayTune(RELAY_TUNE *tune, int32_t center, int32_t hysteresis, int32_t low, int32_t high,
+                   uint32_t timeout);
+int32_t updateRelayTune(RELAY_TUNE *tune, int32_t measured);
+RELAY_TUNE_STATE getRelayTuneState(const RELAY_TUNE *tune);
+uint32_t getRelayTunePeriod(const RELAY_TUNE *tune);
+int32_t getRelayTuneAmplitude(const RELAY_TUNE *tune);
+
+#endif
@@ -21,15 +21,55 @@
 #ifndef UART0_H_
 #define UART0_H_
 
+// Transmit queue drained by the UART0 interrupt (size must be a power of 2)
+#define UART0_TX_BUFFER_SIZE 256
+
+// Action taken by putcUart0 when the transmit queue is full
+typedef enum _UART0_TX_POLICY
+{
+    UART0_TX_DROP_NEWEST,                            // discard the new character
+    UART0_TX_DROP_OLDEST,                            // overwrite the oldest queued character
+    UART0_TX_BLOCK                                   // wait until the interrupt makes room
+} UART0_TX_POLICY;
+
+#define MAX_CHARS 80
+#define MAX_FIELDS 5
+// Struct for holding parsed data from user
+
+typedef struct _USER_DATA
+{
+    char buffer[MAX_CHARS + 1];
+    uint8_t fieldCount;
+    uint8_t fieldPosition[MAX_FIELDS];
+    char fieldType[MAX_FIELDS];
+} USER_DATA;
+
 //-----------------------------------------------------------------------------
 // Subroutines
 //-----------------------------------------------------------------------------
 
+int r_atoi(char *ptr);
+void getsUart0(USER_DATA *data);
+void parseFields (USER_DATA *data);
+char *getFieldString (USER_DATA *data, uint8_t fieldNumber);
+int32_t getFieldInteger (USER_DATA *data, uint8_t fieldNumber);
+int strCmp (const char *str1, const char *str2);
+bool isCommand (USER_DATA *data, const char strCommand[], uint8_t minArguements);
+
 void initUart0();
 void setUart0BaudRate(uint32_t baudRate, uint32_t fcyc);
 void putcUart0(char c);
 void putsUart0(char* str);
 char getcUart0();
 bool kbhitUart0();
+void setUart0TxPolicy(UART0_TX_POLICY policy);
+uint32_t getUart0TxQueuedCount();
+uint32_t getUart0TxDroppedCount();
+void flushUart0();
+void startUart0LineInput();
+bool isUart0LineReady();
+bool getUart0Line(USER_DATA *data);
+uint32_t getUart0RxDroppedCount();
+void uart0Isr();
 
 #endif
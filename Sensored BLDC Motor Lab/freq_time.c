@@ -0,0 +1,149 @@
+// Frequency Counter Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// SIGNAL_IN on PC6 (WT1CCP0), configured by the caller
+//   WTIMER1A counts rising edges, free running
+//   TIMER1A interrupts once per subgate (gate / FREQ_SUBGATES)
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "freq_time.h"
+
+// 40 MHz ticks per ms of gate, split across the subgates
+#define TICKS_PER_GATE_MS 40000
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static uint16_t gate = FREQ_MAX_GATE_MS;
+
+// Edges counted in each subgate, the sum covers the newest filled entries
+static uint32_t counts[FREQ_SUBGATES];
+static uint8_t countIndex = 0;
+static volatile uint8_t filled = 0;
+static volatile uint32_t sum = 0;
+static uint32_t lastEdgeCount = 0;
+static volatile bool updated = false;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Clocks for TIMER1 and WTIMER1 must be enabled by the caller
+void enableCounterMode(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < FREQ_SUBGATES; i++)
+        counts[i] = 0;
+    countIndex = 0;
+    filled = 0;
+    sum = 0;
+    lastEdgeCount = 0;
+
+    // Configure Timer 1 as the subgate time base
+    TIMER1_CTL_R &= ~TIMER_CTL_TAEN;                 // turn-off timer before reconfiguring
+    TIMER1_CFG_R = TIMER_CFG_32_BIT_TIMER;           // configure as 32-bit timer (A+B)
+    TIMER1_TAMR_R = TIMER_TAMR_TAMR_PERIOD;          // configure for periodic mode (count down)
+    TIMER1_TAILR_R = gate * (TICKS_PER_GATE_MS / FREQ_SUBGATES) - 1;
+    TIMER1_ICR_R = TIMER_ICR_TATOCINT;               // clear any stale timeout
+    TIMER1_IMR_R = TIMER_IMR_TATOIM;                 // turn-on interrupts
+
+    // Configure Wide Timer 1 as a free running counter of external events on CCP0 pin
+    WTIMER1_CTL_R &= ~TIMER_CTL_TAEN;                // turn-off counter before reconfiguring
+    WTIMER1_CFG_R = 4;                               // configure as 32-bit counter (A only)
+    WTIMER1_TAMR_R = TIMER_TAMR_TAMR_CAP | TIMER_TAMR_TACDIR; // configure for edge count mode, count up
+    WTIMER1_TAILR_R = 0xFFFFFFFF;                    // count through the full range, deltas handle the wrap
+    WTIMER1_CTL_R = 0;                               // count positive edges
+    WTIMER1_IMR_R = 0;                               // turn-off interrupts
+    WTIMER1_TAV_R = 0;                               // zero counter for first subgate
+    WTIMER1_CTL_R |= TIMER_CTL_TAEN;                 // turn-on counter
+
+    TIMER1_CTL_R |= TIMER_CTL_TAEN;                  // turn-on timer
+    NVIC_EN0_R = 1 << (INT_TIMER1A-16);              // turn-on interrupt 37 (TIMER1A)
+}
+
+void disableCounterMode(void)
+{
+    TIMER1_CTL_R &= ~TIMER_CTL_TAEN;
+    TIMER1_IMR_R = 0;
+    NVIC_DIS0_R = 1 << (INT_TIMER1A-16);
+    WTIMER1_CTL_R &= ~TIMER_CTL_TAEN;
+}
+
+// Gate of 1 ms to 1 s, restarts the measurement if the counter is running
+bool setCounterGate(int32_t gateMs)
+{
+    if (gateMs < FREQ_MIN_GATE_MS || gateMs > FREQ_MAX_GATE_MS)
+        return false;
+    gate = gateMs;
+    if (TIMER1_CTL_R & TIMER_CTL_TAEN)
+        enableCounterMode();
+    return true;
+}
+
+uint16_t getCounterGate(void)
+{
+    return gate;
+}
+
+// True once for each subgate completed since the last call
+bool isCounterUpdated(void)
+{
+    bool result = updated;
+    updated = false;
+    return result;
+}
+
+// Frequency over the newest subgates, in mHz
+// Until the gate has filled once, the subgates counted so far are scaled up to the whole gate
+uint32_t getCounterFrequencyMilliHz(void)
+{
+    uint32_t edges;
+    uint8_t subgates;
+
+    // Mask the subgate interrupt so the sum and its subgate count agree
+    TIMER1_IMR_R = 0;
+    edges = sum;
+    subgates = filled;
+    TIMER1_IMR_R = TIMER_IMR_TATOIM;
+    if (subgates == 0)
+        return 0;
+    return (uint64_t)edges * FREQ_SUBGATES * 1000000 / ((uint32_t)gate * subgates);
+}
+
+// Frequency over the newest subgates, rounded to Hz
+uint32_t getCounterFrequency(void)
+{
+    return (getCounterFrequencyMilliHz() + 500) / 1000;
+}
+
+// Subgate service, the counter is never reset so no edges are lost between subgates
+void timer1Isr(void)
+{
+    uint32_t edgeCount = WTIMER1_TAV_R;              // read counter input
+    uint32_t edges = edgeCount - lastEdgeCount;
+    lastEdgeCount = edgeCount;
+
+    sum = sum - counts[countIndex] + edges;
+    counts[countIndex] = edges;
+    countIndex = (countIndex + 1) % FREQ_SUBGATES;
+    if (filled < FREQ_SUBGATES)
+        filled++;
+    updated = true;
+    TIMER1_ICR_R = TIMER_ICR_TATOCINT;               // clear interrupt flag
+}
@@ -5,13 +5,16 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include "wait.h"
 #include "clock.h"
 #include "tm4c123gh6pm.h"
 #include "gpio.h"
 #include "nvic.h"
 #include "uart0.h"
+#include "format.h"
+#include "telemetry.h"
+#include "command.h"
+#include "freq_time.h"
 
 // Motor driver pins, not actual pwm
 #define pwm1 PORTD,6
@@ -51,34 +54,6 @@ uint16_t rpm = 1;
 
 volatile uint32_t waitTiming = 1;
 
-void enableCounterMode(){
-    // Configure Timer 1 as the time base
-    TIMER1_CTL_R &= ~TIMER_CTL_TAEN;                 // turn-off timer before reconfiguring
-    TIMER1_CFG_R = TIMER_CFG_32_BIT_TIMER;           // configure as 32-bit timer (A+B)
-    TIMER1_TAMR_R = TIMER_TAMR_TAMR_PERIOD;          // configure for periodic mode (count down)
-    TIMER1_TAILR_R = 40000000;                       // set load value to 40e6 for 1 Hz interrupt rate
-    TIMER1_IMR_R = TIMER_IMR_TATOIM;                 // turn-on interrupts
-    TIMER1_CTL_R |= TIMER_CTL_TAEN;                  // turn-on timer
-    NVIC_EN0_R |= 1 << (INT_TIMER1A-16);             // turn-on interrupt 37 (TIMER1A)
-
-    // Configure Wide Timer 1 as counter of external events on CCP0 pin
-    WTIMER1_CTL_R &= ~TIMER_CTL_TAEN;                // turn-off counter before reconfiguring
-    WTIMER1_CFG_R = 4;                               // configure as 32-bit counter (A only)
-    WTIMER1_TAMR_R = TIMER_TAMR_TAMR_CAP | TIMER_TAMR_TACDIR; // configure for edge count mode, count up
-    WTIMER1_CTL_R = 0;                               //
-    WTIMER1_IMR_R = 0;                               // turn-off interrupts
-    WTIMER1_TAV_R = 0;                               // zero counter for first period
-    WTIMER1_CTL_R |= TIMER_CTL_TAEN;                 // turn-on counter
-    //enablePinInterrupt(PORTC,6);
-}
-
-// Frequency counter service publishing latest frequency measurements every second
-void timer1Isr(){
-    frequency = WTIMER1_TAV_R;                   // read counter input
-    WTIMER1_TAV_R = 0;                           // reset counter for next period
-    TIMER1_ICR_R = TIMER_ICR_TATOCINT;           // clear interrupt flag
-}
-
 void wideTimer1Isr(){
     time = WTIMER1_TAV_R;                        // read counter input
     WTIMER1_TAV_R = 0;                           // zero counter for next edge
@@ -237,12 +212,58 @@ void step_CW(){
         }
         setElectricalPhase(phase);
 }
+// Console commands, dispatched through the hashed table in command.c
+void binaryCommand(const COMMAND_ARGS *args){
+    setTelemetryMode(TELEMETRY_BINARY);
+}
+
+void textCommand(const COMMAND_ARGS *args){
+    setTelemetryMode(TELEMETRY_TEXT);
+}
+
+void delayCommand(const COMMAND_ARGS *args){
+    waitTiming = args->integer[0];
+}
+
+// gate MS sets the hall counter gate, gate alone shows it
+void gateCommand(const COMMAND_ARGS *args){
+    if (args->count == 1 && !setCounterGate(args->integer[0])){
+        putsUart0("Gate is 1 to 1000 ms\n");
+    }
+    putsUart0("Gate: ");
+    putDecUart0(getCounterGate(), 0);
+    putsUart0(" (ms)\n");
+}
+
+const COMMAND commands[] =
+{
+    {"binary", 0, "", binaryCommand},
+    {"text", 0, "", textCommand},
+    {"delay", 1, "n", delayCommand},
+    {"gate", 0, "n", gateCommand}
+};
+
+void processCommand(USER_DATA *data){
+    COMMAND_STATUS status = runCommand(data);
+    if (getTelemetryMode() == TELEMETRY_TEXT){
+        putCommandStatusUart0(status);
+    }
+}
+
 int main(void){
-    char str[10];
+    uint32_t electricalFrequency;
+    uint32_t delay;
+    USER_DATA data;
+
     initHw();
     initUart0();
     setUart0BaudRate(115200, 40e6);
     enableCounterMode();
+    initTelemetry();
+    startUart0LineInput();
+    if (!initCommands(commands, sizeof(commands) / sizeof(commands[0]))){
+        putsUart0("Command table init failed\n");
+    }
 
     //bool flag = true;
     phase = 0;
@@ -262,24 +283,33 @@ int main(void){
         if (!getPinValue(SW1) && waitTiming <= 1000000){
             waitTiming -= 100;
         }
-        putsUart0("Frequency: ");
-        sprintf(str, "%7lu", frequency / 2);
-        putsUart0(str);
-        putsUart0(" (Hz)\n");
-
-        waitMicrosecond(10000);
+        frequency = getCounterFrequency();
+        electricalFrequency = frequency / 2;
         //(Hz x 60 x 2) / number of poles = no-load RPM
-
-        putsUart0("RPM: ");
         rpm = ((frequency * 60) / 4 );
-        sprintf(str, "%7lu", rpm);
-        putsUart0(str);
-        putsUart0("\n");
-
-        putsUart0("WaitTime: ");
-        sprintf(str, "%7lu", waitTiming);
-        putsUart0(str);
-        putsUart0("\n");
+        delay = waitTiming;
+
+        if (getUart0Line(&data)){
+            processCommand(&data);
+        }
+        if (getTelemetryMode() == TELEMETRY_TEXT){
+            putsUart0("Frequency: ");
+            putDecUart0(electricalFrequency, 7);
+            putsUart0(" (Hz)\n");
+
+            putsUart0("RPM: ");
+            putDecUart0(rpm, 7);
+            putsUart0("\n");
+
+            putsUart0("WaitTime: ");
+            putDecUart0(delay, 7);
+            putsUart0("\n");
+        }
+        sendTelemetry(TELEMETRY_FREQUENCY, TELEMETRY_U32, &electricalFrequency, 1);
+        sendTelemetry(TELEMETRY_RPM, TELEMETRY_U16, &rpm, 1);
+        sendTelemetry(TELEMETRY_COMMUTATION_DELAY, TELEMETRY_U32, &delay, 1);
+
+        waitMicrosecond(10000);
 
 
 
@@ -0,0 +1,146 @@
+// Telemetry Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// Records are written through putcUart0
+// Wide Timer 5A free-runs at 1 MHz as the record timestamp
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "uart0.h"
+#include "telemetry.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static TELEMETRY_MODE mode = TELEMETRY_TEXT;
+static uint8_t record[TELEMETRY_HEADER_SIZE + TELEMETRY_MAX_PAYLOAD + 2];
+
+// CRC-16/CCITT-FALSE (poly 0x1021), one entry per nibble
+static const uint16_t crcTable[16] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+static const uint8_t typeSize[8] = {0, 1, 1, 2, 2, 4, 4, 4};
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Start the 1 MHz timestamp timer, output starts in text mode
+void initTelemetry(void)
+{
+    // Enable clocks
+    SYSCTL_RCGCWTIMER_R |= SYSCTL_RCGCWTIMER_R5;
+    _delay_cycles(3);
+
+    // Configure Wide Timer 5A as a free-running 32-bit timer with a /40 prescaler
+    WTIMER5_CTL_R &= ~TIMER_CTL_TAEN;                // turn-off timer before reconfiguring
+    WTIMER5_CFG_R = 4;                               // configure as 32-bit timer (A only)
+    WTIMER5_TAMR_R = TIMER_TAMR_TAMR_PERIOD;         // configure for periodic mode (count down)
+    WTIMER5_TAPR_R = 40 - 1;                         // 40 MHz / 40 = 1 MHz
+    WTIMER5_TAILR_R = 0xFFFFFFFF;
+    WTIMER5_CTL_R |= TIMER_CTL_TAEN;                 // turn-on timer
+
+    mode = TELEMETRY_TEXT;
+}
+
+void setTelemetryMode(TELEMETRY_MODE newMode)
+{
+    mode = newMode;
+}
+
+TELEMETRY_MODE getTelemetryMode(void)
+{
+    return mode;
+}
+
+// Microseconds since initTelemetry, wraps after about 71 minutes
+uint32_t getTelemetryTimestamp(void)
+{
+    return 0xFFFFFFFF - WTIMER5_TAV_R;
+}
+
+static uint16_t crc16(const uint8_t data[], uint16_t length)
+{
+    uint16_t crc = 0xFFFF;
+    uint16_t i;
+    for (i = 0; i < length; i++)
+    {
+        crc = (crc << 4) ^ crcTable[(crc >> 12) ^ (data[i] >> 4)];
+        crc = (crc << 4) ^ crcTable[(crc >> 12) ^ (data[i] & 15)];
+    }
+    return crc;
+}
+
+// COBS encode the record straight into the transmit queue and add the 0x00 delimiter
+// Records are shorter than 254 bytes, so each code byte is just the distance to the next zero
+static void putCobsUart0(const uint8_t data[], uint16_t length)
+{
+    uint16_t start = 0;
+    uint16_t end;
+    while (start <= length)
+    {
+        end = start;
+        while (end < length && data[end] != 0)
+            end++;
+        putcUart0(end - start + 1);
+        while (start < end)
+            putcUart0(data[start++]);
+        start = end + 1;                             // skip the zero the code byte replaced
+    }
+    putcUart0(0);
+}
+
+/*
+ * Send count elements of the given type as one framed record on a channel
+ * Does nothing in text mode, so callers can send unconditionally
+ * Not reentrant, call from the main loop only
+ */
+void sendTelemetry(uint8_t channel, TELEMETRY_TYPE type, const void *payload, uint8_t count)
+{
+    const uint8_t *bytes = payload;
+    uint32_t timestamp;
+    uint16_t length;
+    uint16_t crc;
+    uint16_t i;
+
+    if (mode != TELEMETRY_BINARY)
+        return;
+
+    length = count * typeSize[type & 7];
+    if (length > TELEMETRY_MAX_PAYLOAD)
+        length = TELEMETRY_MAX_PAYLOAD;
+
+    timestamp = getTelemetryTimestamp();
+    record[0] = channel;
+    record[1] = type;
+    record[2] = timestamp;
+    record[3] = timestamp >> 8;
+    record[4] = timestamp >> 16;
+    record[5] = timestamp >> 24;
+    for (i = 0; i < length; i++)
+        record[TELEMETRY_HEADER_SIZE + i] = bytes[i];
+    length += TELEMETRY_HEADER_SIZE;
+
+    crc = crc16(record, length);
+    record[length++] = crc;
+    record[length++] = crc >> 8;
+
+    putCobsUart0(record, length);
+}
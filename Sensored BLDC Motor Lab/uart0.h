@@ -21,6 +21,16 @@
 #ifndef UART0_H_
 #define UART0_H_
 
+// Transmit queue drained by the UART0 interrupt (size must be a power of 2)
+#define UART0_TX_BUFFER_SIZE 256
+
+// Action taken by putcUart0 when the transmit queue is full
+typedef enum _UART0_TX_POLICY
+{
+    UART0_TX_DROP_NEWEST,                            // discard the new character
+    UART0_TX_DROP_OLDEST,                            // overwrite the oldest queued character
+    UART0_TX_BLOCK                                   // wait until the interrupt makes room
+} UART0_TX_POLICY;
 
 #define MAX_CHARS 80
 #define MAX_FIELDS 5
@@ -53,5 +63,14 @@ void putcUart0(char c);
 void putsUart0(char* str);
 char getcUart0(void);
 bool kbhitUart0(void);
+void setUart0TxPolicy(UART0_TX_POLICY policy);
+uint32_t getUart0TxQueuedCount(void);
+uint32_t getUart0TxDroppedCount(void);
+void flushUart0(void);
+void startUart0LineInput(void);
+bool isUart0LineReady(void);
+bool getUart0Line(USER_DATA *data);
+uint32_t getUart0RxDroppedCount(void);
+void uart0Isr(void);
 
 #endif
@@ -0,0 +1,128 @@
+// Capture Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// None, records the raw samples passed in by the caller
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "capture.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// Samples are written round the ring until the trigger, so the pre-trigger
+// samples are always the newest ones before it
+static int32_t ring[CAPTURE_SIZE];
+static uint16_t writeIndex = 0;
+static uint16_t filled = 0;                          // samples since arming, up to CAPTURE_SIZE
+static uint16_t remaining = 0;                       // post-trigger samples still to take
+static uint16_t preTriggerCount = 0;
+
+static CAPTURE_STATE state = CAPTURE_IDLE;
+static CAPTURE_TRIGGER mode = CAPTURE_LEVEL;
+static int32_t triggerThreshold = 0;
+static int32_t reference = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Starts a new capture, keeping preTrigger samples from before the trigger
+void armCapture(CAPTURE_TRIGGER trigger, int32_t threshold, uint16_t preTrigger)
+{
+    if (preTrigger >= CAPTURE_SIZE)
+        preTrigger = CAPTURE_SIZE - 1;
+    mode = trigger;
+    triggerThreshold = threshold;
+    preTriggerCount = preTrigger;
+    writeIndex = 0;
+    filled = 0;
+    state = CAPTURE_ARMED;
+}
+
+void stopCapture(void)
+{
+    state = CAPTURE_IDLE;
+}
+
+CAPTURE_STATE getCaptureState(void)
+{
+    return state;
+}
+
+// Called for every sample so the slope reference is always the previous one
+static bool isTriggered(int32_t sample)
+{
+    int32_t difference;
+    if (filled == 0)
+        reference = sample;
+    difference = sample - reference;
+    if (mode == CAPTURE_SLOPE)
+        reference = sample;
+    return difference >= triggerThreshold || difference <= -triggerThreshold;
+}
+
+// Returns true when this sample completes the capture
+bool addCaptureSample(int32_t sample)
+{
+    bool triggered;
+
+    if (state != CAPTURE_ARMED && state != CAPTURE_TRIGGERED)
+        return false;
+    triggered = isTriggered(sample);
+
+    ring[writeIndex] = sample;
+    writeIndex = (writeIndex + 1) & (CAPTURE_SIZE - 1);
+    if (filled < CAPTURE_SIZE)
+        filled++;
+
+    if (state == CAPTURE_ARMED)
+    {
+        // Only trigger once the pre-trigger part holds samples from this capture
+        if (filled <= preTriggerCount || !triggered)
+            return false;
+        state = CAPTURE_TRIGGERED;
+        remaining = CAPTURE_SIZE - preTriggerCount - 1;
+    }
+    else
+        remaining--;
+
+    if (remaining > 0)
+        return false;
+    state = CAPTURE_DONE;
+    return true;
+}
+
+// Position of the trigger sample in a finished capture
+uint16_t getCaptureTriggerIndex(void)
+{
+    return preTriggerCount;
+}
+
+// Copies up to count samples of a finished capture in time order, starting at sample first
+uint8_t readCapture(int32_t samples[], uint16_t first, uint8_t count)
+{
+    uint8_t i;
+    if (state != CAPTURE_DONE || first >= CAPTURE_SIZE)
+        return 0;
+    if (count > CAPTURE_SIZE - first)
+        count = CAPTURE_SIZE - first;
+
+    // The ring is full once done, so the oldest sample is the next one to be written
+    for (i = 0; i < count; i++)
+        samples[i] = ring[(writeIndex + first + i) & (CAPTURE_SIZE - 1)];
+    return count;
+}
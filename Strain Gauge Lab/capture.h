@@ -0,0 +1,52 @@
+// Capture Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// None, records the raw samples passed in by the caller
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef CAPTURE_H_
+#define CAPTURE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Samples per capture (size must be a power of 2)
+#define CAPTURE_SIZE 512
+
+typedef enum _CAPTURE_TRIGGER
+{
+    CAPTURE_LEVEL,                                   // sample differs from the first sample after arming by the threshold
+    CAPTURE_SLOPE                                    // sample differs from the previous sample by the threshold
+} CAPTURE_TRIGGER;
+
+typedef enum _CAPTURE_STATE
+{
+    CAPTURE_IDLE,
+    CAPTURE_ARMED,                                   // filling the pre-trigger samples and waiting for the trigger
+    CAPTURE_TRIGGERED,                               // filling the post-trigger samples
+    CAPTURE_DONE                                     // frozen until read out
+} CAPTURE_STATE;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void armCapture(CAPTURE_TRIGGER trigger, int32_t threshold, uint16_t preTrigger);
+void stopCapture(void);
+CAPTURE_STATE getCaptureState(void);
+bool addCaptureSample(int32_t sample);
+uint16_t getCaptureTriggerIndex(void);
+uint8_t readCapture(int32_t samples[], uint16_t first, uint8_t count);
+
+#endif
@@ -0,0 +1,159 @@
+// Command Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Commands arrive as USER_DATA lines from the UART0 line editor
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "uart0.h"
+#include "command.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// Registered table and its hash index, each bucket holds a table index + 1 (0 = empty)
+static const COMMAND *commands = 0;
+static uint8_t buckets[COMMAND_BUCKETS];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static char lowerCase(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? c + 32 : c;
+}
+
+// FNV-1a of the lower case name, so lookups stay case-insensitive like strCmp
+static uint32_t hashName(const char *name)
+{
+    uint32_t hash = 2166136261;
+    while (*name)
+    {
+        hash ^= (uint8_t)lowerCase(*name++);
+        hash *= 16777619;
+    }
+    return hash;
+}
+
+static bool isSameName(const char *str1, const char *str2)
+{
+    while (*str1 && lowerCase(*str1) == lowerCase(*str2))
+    {
+        str1++;
+        str2++;
+    }
+    return *str1 == *str2;
+}
+
+/*
+ * Hash the command table into the bucket index with linear probing
+ * The table must stay valid while commands are run
+ * Returns false if a name is registered twice or the table does not fit
+ */
+bool initCommands(const COMMAND table[], uint8_t count)
+{
+    uint8_t i;
+    uint8_t bucket;
+
+    for (i = 0; i < COMMAND_BUCKETS; i++)
+        buckets[i] = 0;
+    commands = table;
+
+    if (count > COMMAND_BUCKETS / 2)
+        return false;
+    for (i = 0; i < count; i++)
+    {
+        bucket = hashName(table[i].name) & (COMMAND_BUCKETS - 1);
+        while (buckets[bucket] != 0)
+        {
+            if (isSameName(table[buckets[bucket] - 1].name, table[i].name))
+                return false;
+            bucket = (bucket + 1) & (COMMAND_BUCKETS - 1);
+        }
+        buckets[bucket] = i + 1;
+    }
+    return true;
+}
+
+static const COMMAND *findCommand(const char *name)
+{
+    uint8_t bucket = hashName(name) & (COMMAND_BUCKETS - 1);
+    const COMMAND *command;
+
+    while (buckets[bucket] != 0)
+    {
+        command = &commands[buckets[bucket] - 1];
+        if (isSameName(command->name, name))
+            return command;
+        bucket = (bucket + 1) & (COMMAND_BUCKETS - 1);
+    }
+    return 0;
+}
+
+/*
+ * Look up the first field of a parsed line and call its handler
+ * Arguments are checked against the command's types and converted before the call
+ */
+COMMAND_STATUS runCommand(USER_DATA *data)
+{
+    const COMMAND *command;
+    COMMAND_ARGS args;
+    uint8_t field;
+    uint8_t i;
+
+    if (data->fieldCount == 0)
+        return COMMAND_EMPTY;
+    command = findCommand(&data->buffer[data->fieldPosition[0]]);
+    if (command == 0)
+        return COMMAND_UNKNOWN;
+
+    args.count = data->fieldCount - 1;
+    if (args.count < command->minArgs)
+        return COMMAND_MISSING_ARGUMENT;
+
+    for (i = 0; i < args.count; i++)
+    {
+        field = i + 1;
+        args.string[i] = &data->buffer[data->fieldPosition[field]];
+        args.integer[i] = 0;
+        if (command->argTypes[i] == '\0')
+        {
+            args.count = i;                          // extra fields are ignored
+            break;
+        }
+        if (command->argTypes[i] == 'n')
+        {
+            if (data->fieldType[field] != 'n')
+                return COMMAND_INVALID_ARGUMENT;
+            args.integer[i] = r_atoi(args.string[i]);
+        }
+    }
+
+    command->handler(&args);
+    return COMMAND_OK;
+}
+
+// Print the reason a command was not run
+void putCommandStatusUart0(COMMAND_STATUS status)
+{
+    if (status == COMMAND_UNKNOWN)
+        putsUart0("Invalid command\n");
+    else if (status == COMMAND_MISSING_ARGUMENT)
+        putsUart0("Missing argument\n");
+    else if (status == COMMAND_INVALID_ARGUMENT)
+        putsUart0("Invalid argument\n");
+}
@@ -0,0 +1,120 @@
+// Filter Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// None, operates on samples passed in by the caller
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "filter.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Thresholds are in input units: a step is a jump away from the current average,
+// stable means the last SETTLE_STABLE_SAMPLES span no more than stableThreshold
+void initSettlingFilter(SETTLING_FILTER *filter, int32_t stepThreshold, int32_t stableThreshold)
+{
+    filter->index = 0;
+    filter->count = 0;
+    filter->deviations = 0;
+    filter->sum = 0;
+    filter->stepThreshold = stepThreshold;
+    filter->stableThreshold = stableThreshold;
+    filter->stable = false;
+}
+
+// Sum of the newest count samples
+static int32_t sumNewest(const SETTLING_FILTER *filter, uint8_t count)
+{
+    int32_t sum = 0;
+    uint8_t i = filter->index;
+    while (count--)
+    {
+        i = (i - 1) & (SETTLE_MAX_WINDOW - 1);
+        sum += filter->samples[i];
+    }
+    return sum;
+}
+
+// True if the newest SETTLE_STABLE_SAMPLES samples lie within the stable threshold of each other
+static bool isNewestSpanStable(const SETTLING_FILTER *filter)
+{
+    uint8_t i = filter->index;
+    uint8_t n;
+    int32_t min;
+    int32_t max;
+    int32_t value;
+
+    i = (i - 1) & (SETTLE_MAX_WINDOW - 1);
+    min = max = filter->samples[i];
+    for (n = 1; n < SETTLE_STABLE_SAMPLES; n++)
+    {
+        i = (i - 1) & (SETTLE_MAX_WINDOW - 1);
+        value = filter->samples[i];
+        if (value < min)
+            min = value;
+        if (value > max)
+            max = value;
+    }
+    return max - min <= filter->stableThreshold;
+}
+
+// Adds a sample and returns the average of the current window
+int32_t updateSettlingFilter(SETTLING_FILTER *filter, int32_t sample)
+{
+    int32_t deviation;
+
+    // Compare against the average before this sample joins it
+    if (filter->count > 0)
+    {
+        deviation = sample - filter->sum / filter->count;
+        if (deviation > filter->stepThreshold || deviation < -filter->stepThreshold)
+            filter->deviations++;
+        else
+            filter->deviations = 0;
+    }
+
+    // Once the window spans the whole ring, the entry overwritten is the oldest in the window
+    if (filter->count == SETTLE_MAX_WINDOW)
+        filter->sum -= filter->samples[filter->index];
+    else
+        filter->count++;
+    filter->samples[filter->index] = sample;
+    filter->index = (filter->index + 1) & (SETTLE_MAX_WINDOW - 1);
+    filter->sum += sample;
+
+    // A sustained jump is a load change, not noise, so drop the samples from before it
+    if (filter->deviations >= SETTLE_STEP_SAMPLES)
+    {
+        filter->count = filter->deviations;
+        filter->sum = sumNewest(filter, filter->count);
+        filter->deviations = 0;
+    }
+
+    filter->stable = filter->count >= SETTLE_STABLE_SAMPLES && isNewestSpanStable(filter);
+    return filter->sum / filter->count;
+}
+
+bool isSettlingFilterStable(const SETTLING_FILTER *filter)
+{
+    return filter->stable;
+}
+
+// Number of samples currently averaged
+uint8_t getSettlingFilterWindow(const SETTLING_FILTER *filter)
+{
+    return filter->count;
+}
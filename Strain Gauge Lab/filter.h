@@ -0,0 +1,60 @@
+// Filter Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// None, operates on samples passed in by the caller
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef FILTER_H_
+#define FILTER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Longest averaging window (size must be a power of 2)
+#define SETTLE_MAX_WINDOW 64
+
+// Consecutive samples beyond the step threshold that restart the window
+#define SETTLE_STEP_SAMPLES 2
+
+// Samples that must agree within the stable threshold before the output is flagged stable
+#define SETTLE_STABLE_SAMPLES 8
+
+/*
+ * Moving average whose window adapts to the signal
+ * A step restarts the window with the samples taken since the step,
+ * so the output follows motion quickly, then the window grows back to
+ * SETTLE_MAX_WINDOW while the input is at rest
+ */
+typedef struct _SETTLING_FILTER
+{
+    int32_t samples[SETTLE_MAX_WINDOW];
+    uint8_t index;                                   // next entry to write
+    uint8_t count;                                   // samples in the current window
+    uint8_t deviations;                              // consecutive samples beyond the step threshold
+    int32_t sum;                                     // sum of the current window
+    int32_t stepThreshold;
+    int32_t stableThreshold;
+    bool stable;
+} SETTLING_FILTER;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initSettlingFilter(SETTLING_FILTER *filter, int32_t stepThreshold, int32_t stableThreshold);
+int32_t updateSettlingFilter(SETTLING_FILTER *filter, int32_t sample);
+bool isSettlingFilterStable(const SETTLING_FILTER *filter);
+uint8_t getSettlingFilterWindow(const SETTLING_FILTER *filter);
+
+#endif
@@ -0,0 +1,202 @@
+// HX711 Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// HX711 24-bit load cell ADC:
+//   PD_SCK on PA2 (SSI0Clk), DOUT on PA4 (SSI0Rx), RATE on PA3 (low 10 SPS, high 80 SPS)
+//   Boards that tie RATE to ground need that link cut to reach 80 SPS
+//   DOUT is a falling edge GPIO interrupt while waiting for a conversion,
+//   then SSI0 clocks the result out at 1 MHz and interrupts once at end of transmission
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "gpio.h"
+#include "nvic.h"
+#include "hx711.h"
+
+// Pins
+#define HX711_CLK PORTA,2
+#define HX711_DATA PORTA,4
+#define HX711_RATE_PIN PORTA,3
+
+// SSI0 format without the data size, which changes with the number of pulses
+#define HX711_CR0 ((3 << SSI_CR0_SCR_S) | SSI_CR0_SPH | SSI_CR0_FRF_MOTO)
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static volatile int32_t sample = 0;
+static volatile uint32_t sampleCount = 0;
+
+// 24 data bits plus 1-3 gain pulses, split into equal SSI frames of 4-16 bits
+// Indexed by pulses - 25: 5 x 5 (A/128), 2 x 13 (B/32), 3 x 9 (A/64)
+static const uint8_t frameCount[3] = {5, 2, 3};
+static const uint8_t frameBits[3] = {5, 13, 9};
+
+static HX711_GAIN gain = HX711_A_128;               // selected by setHx711Gain
+static HX711_GAIN conversionGain = HX711_A_128;     // setting of the conversion in progress (power-up default)
+static HX711_GAIN readGain = HX711_A_128;           // pulses sent by the current read
+
+static volatile int32_t queue[HX711_QUEUE_SIZE];
+static volatile uint8_t queueWriteIndex = 0;
+static volatile uint8_t queueReadIndex = 0;
+static uint32_t overflowCount = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Initialize SSI0 as the PD_SCK master and start waiting for the first conversion
+void initHx711(void)
+{
+    // Enable clocks
+    SYSCTL_RCGCSSI_R |= SYSCTL_RCGCSSI_R0;
+    _delay_cycles(3);
+    enablePort(PORTA);
+
+    // Configure PD_SCK as the SSI0 clock (idles low so the HX711 stays powered up)
+    selectPinPushPullOutput(HX711_CLK);
+    setPinValue(HX711_CLK, 0);
+    setPinAuxFunction(HX711_CLK, GPIO_PCTL_PA2_SSI0CLK);
+
+    // Configure SSI0 as a 1 MHz SPI master, sampling DOUT on the falling edge (SPO = 0, SPH = 1)
+    SSI0_CR1_R = 0;                                  // turn-off SSI0 to allow safe programming
+    SSI0_CC_R = SSI_CC_CS_SYSPLL;                    // use system clock (40 MHz)
+    SSI0_CPSR_R = 10;                                // 40 MHz / (10 * (1 + 3)) = 1 MHz
+    SSI0_CR0_R = HX711_CR0 | (frameBits[readGain - HX711_A_128] - 1);
+    SSI0_CR1_R = SSI_CR1_EOT | SSI_CR1_SSE;          // tx interrupt means transmission complete, turn-on SSI0
+    SSI0_IM_R = 0;                                   // unmasked only while a conversion is read
+    enableNvicInterrupt(INT_SSI0);
+
+    // Configure RATE, starting at 10 SPS
+    selectPinPushPullOutput(HX711_RATE_PIN);
+    setPinValue(HX711_RATE_PIN, 0);
+
+    // Configure DOUT as a data ready interrupt
+    disablePinInterrupt(HX711_DATA);
+    selectPinDigitalInput(HX711_DATA);
+    enablePinPulldown(HX711_DATA);
+    selectPinInterruptFallingEdge(HX711_DATA);
+    clearPinInterrupt(HX711_DATA);
+    enablePinInterrupt(HX711_DATA);
+    enableNvicInterrupt(INT_GPIOA);
+}
+
+// Sets the priority of both driver interrupts (0 highest, 7 lowest)
+void setHx711InterruptPriority(uint8_t priority)
+{
+    setNvicInterruptPriority(INT_GPIOA, priority);
+    setNvicInterruptPriority(INT_SSI0, priority);
+}
+
+// Selects the input and gain, conversions made with the old setting are not queued
+void setHx711Gain(HX711_GAIN newGain)
+{
+    gain = newGain;
+}
+
+HX711_GAIN getHx711Gain(void)
+{
+    return gain;
+}
+
+// Drives the RATE pin, the HX711 then needs about 4 conversions to settle
+void setHx711Rate(HX711_RATE rate)
+{
+    setPinValue(HX711_RATE_PIN, rate == HX711_RATE_80SPS);
+}
+
+// Latest conversion, sign extended from 24 bits
+int32_t getHx711Sample(void)
+{
+    return sample;
+}
+
+// Number of conversions read since initHx711
+uint32_t getHx711SampleCount(void)
+{
+    return sampleCount;
+}
+
+// Takes the oldest queued conversion, returns false if the queue is empty
+bool readHx711Sample(int32_t *value)
+{
+    if (queueReadIndex == queueWriteIndex)
+        return false;
+    *value = queue[queueReadIndex];
+    queueReadIndex = (queueReadIndex + 1) & (HX711_QUEUE_SIZE - 1);
+    return true;
+}
+
+// Number of conversions lost because the queue was full
+uint32_t getHx711OverflowCount(void)
+{
+    return overflowCount;
+}
+
+// GPIO Port A interrupt: DOUT fell, so hand the pin to SSI0 and queue the clock pulses
+void hx711ReadyIsr(void)
+{
+    uint8_t i;
+
+    disablePinInterrupt(HX711_DATA);
+    clearPinInterrupt(HX711_DATA);
+    if (readGain != gain)
+    {
+        readGain = gain;
+        SSI0_CR1_R &= ~SSI_CR1_SSE;                  // frame size can only change while disabled
+        SSI0_CR0_R = HX711_CR0 | (frameBits[readGain - HX711_A_128] - 1);
+        SSI0_CR1_R |= SSI_CR1_SSE;
+    }
+    setPinAuxFunction(HX711_DATA, GPIO_PCTL_PA4_SSI0RX);
+    for (i = 0; i < frameCount[readGain - HX711_A_128]; i++)
+        SSI0_DR_R = 0;
+    SSI0_IM_R = SSI_IM_TXIM;                         // interrupt once the last pulse has been sent
+}
+
+// SSI0 interrupt: assemble the frames, queue the conversion and go back to waiting for DOUT to fall
+void hx711Isr(void)
+{
+    uint8_t bits = frameBits[readGain - HX711_A_128];
+    uint32_t value = 0;
+    uint8_t next;
+
+    SSI0_IM_R = 0;
+    while (SSI0_SR_R & SSI_SR_RNE)
+        value = (value << bits) | (SSI0_DR_R & ((1 << bits) - 1));
+    value >>= readGain - 24;                         // drop the gain selection pulses
+    sample = (int32_t)(value << 8) >> 8;
+    sampleCount++;
+
+    if (conversionGain == gain)
+    {
+        next = (queueWriteIndex + 1) & (HX711_QUEUE_SIZE - 1);
+        if (next == queueReadIndex)
+        {
+            overflowCount++;
+        }
+        else
+        {
+            queue[queueWriteIndex] = sample;
+            queueWriteIndex = next;
+        }
+    }
+    conversionGain = readGain;                       // the pulses just sent set up the next conversion
+
+    setPinAuxFunction(HX711_DATA, 0);
+    clearPinInterrupt(HX711_DATA);                   // edges seen while the bits were shifted out
+    enablePinInterrupt(HX711_DATA);
+}
@@ -0,0 +1,60 @@
+// HX711 Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// HX711 24-bit load cell ADC:
+//   PD_SCK on PA2 (SSI0Clk), DOUT on PA4 (SSI0Rx), RATE on PA3 (low 10 SPS, high 80 SPS)
+//   DOUT is a falling edge GPIO interrupt while waiting for a conversion,
+//   then SSI0 clocks the result out at 1 MHz and interrupts once at end of transmission
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef HX711_H_
+#define HX711_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// PD_SCK pulses per read, which select the input and gain of the next conversion
+typedef enum _HX711_GAIN
+{
+    HX711_A_128 = 25,
+    HX711_B_32 = 26,
+    HX711_A_64 = 27
+} HX711_GAIN;
+
+typedef enum _HX711_RATE
+{
+    HX711_RATE_10SPS,
+    HX711_RATE_80SPS
+} HX711_RATE;
+
+// Conversions held until the main loop reads them (size must be a power of 2)
+#define HX711_QUEUE_SIZE 32
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initHx711(void);
+void setHx711InterruptPriority(uint8_t priority);
+void setHx711Gain(HX711_GAIN gain);
+HX711_GAIN getHx711Gain(void);
+void setHx711Rate(HX711_RATE rate);
+int32_t getHx711Sample(void);
+uint32_t getHx711SampleCount(void);
+bool readHx711Sample(int32_t *value);
+uint32_t getHx711OverflowCount(void);
+void hx711ReadyIsr(void);
+void hx711Isr(void);
+
+#endif
@@ -0,0 +1,218 @@
+// HX711 Array Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// Up to 4 HX711 load cell ADCs read in parallel:
+//   DOUT of cell n on PEn (PE0-PE3), shared PD_SCK on PE4, shared RATE on PE5
+//   Timer 2A paces PD_SCK at 250 kHz, each high phase samples every DOUT with one port read
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "gpio.h"
+#include "nvic.h"
+#include "hx711array.h"
+
+// Pins
+#define HX711_ARRAY_CLK PORTE,4
+#define HX711_ARRAY_RATE PORTE,5
+
+// PortE masks
+#define DATA_MASK ((1 << HX711_ARRAY_CELLS) - 1)
+
+// Half of the 4 us PD_SCK period at 40 MHz
+#define HALF_PERIOD 80
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// One port snapshot per data bit, bit n of each entry belongs to cell n
+typedef struct _HX711_ARRAY_FRAME
+{
+    uint8_t bits[24];
+} HX711_ARRAY_FRAME;
+
+static HX711_ARRAY_FRAME queue[HX711_ARRAY_QUEUE_SIZE];
+static volatile uint8_t queueWriteIndex = 0;
+static volatile uint8_t queueReadIndex = 0;
+static uint32_t overflowCount = 0;
+
+static HX711_GAIN gain = HX711_A_128;               // selected by setHx711ArrayGain
+static HX711_GAIN conversionGain = HX711_A_128;     // setting of the conversions in progress
+static HX711_GAIN readGain = HX711_A_128;           // pulses sent by the current read
+
+// Clock state machine, run by hx711ArrayClockIsr
+static HX711_ARRAY_FRAME frame;
+static uint8_t pulse = 0;
+static bool clockHigh = false;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Starts clocking once every cell has a conversion ready (all DOUT low)
+static void startRead(void)
+{
+    if (GPIO_PORTE_DATA_R & DATA_MASK)
+        return;
+    GPIO_PORTE_IM_R &= ~DATA_MASK;                   // DOUT toggles while bits shift out
+    readGain = gain;
+    pulse = 0;
+    clockHigh = false;
+    TIMER2_TAV_R = 0;
+    TIMER2_CTL_R |= TIMER_CTL_TAEN;
+}
+
+// Initialize the shared clock, rate and data pins and Timer 2A
+void initHx711Array(void)
+{
+    uint8_t i;
+
+    // Enable clocks
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R2;
+    _delay_cycles(3);
+    enablePort(PORTE);
+
+    // Configure PD_SCK (low keeps the cells powered up) and RATE (10 SPS)
+    selectPinPushPullOutput(HX711_ARRAY_CLK);
+    setPinValue(HX711_ARRAY_CLK, 0);
+    selectPinPushPullOutput(HX711_ARRAY_RATE);
+    setPinValue(HX711_ARRAY_RATE, 0);
+
+    // Configure Timer 2A as the PD_SCK half period tick, started for each read
+    TIMER2_CTL_R &= ~TIMER_CTL_TAEN;                 // turn-off timer before reconfiguring
+    TIMER2_CFG_R = TIMER_CFG_32_BIT_TIMER;           // configure as 32-bit timer (A+B)
+    TIMER2_TAMR_R = TIMER_TAMR_TAMR_PERIOD;          // configure for periodic mode (count down)
+    TIMER2_TAILR_R = HALF_PERIOD - 1;
+    TIMER2_IMR_R = TIMER_IMR_TATOIM;                 // turn-on interrupts
+    enableNvicInterrupt(INT_TIMER2A);
+
+    // Configure each DOUT as a data ready interrupt
+    for (i = 0; i < HX711_ARRAY_CELLS; i++)
+    {
+        disablePinInterrupt(PORTE, i);
+        selectPinDigitalInput(PORTE, i);
+        enablePinPulldown(PORTE, i);
+        selectPinInterruptFallingEdge(PORTE, i);
+    }
+    GPIO_PORTE_ICR_R = DATA_MASK;
+    GPIO_PORTE_IM_R |= DATA_MASK;
+    enableNvicInterrupt(INT_GPIOE);
+}
+
+// Sets the priority of both driver interrupts (0 highest, 7 lowest)
+// PD_SCK held high for more than 60 us powers the cells down, so keep the clock tick above long isrs
+void setHx711ArrayInterruptPriority(uint8_t priority)
+{
+    setNvicInterruptPriority(INT_GPIOE, priority);
+    setNvicInterruptPriority(INT_TIMER2A, priority);
+}
+
+// Selects the input and gain of every cell, conversions made with the old setting are not queued
+void setHx711ArrayGain(HX711_GAIN newGain)
+{
+    gain = newGain;
+}
+
+void setHx711ArrayRate(HX711_RATE rate)
+{
+    setPinValue(HX711_ARRAY_RATE, rate == HX711_RATE_80SPS);
+}
+
+/*
+ * Takes the oldest queued conversion and transposes it into one sign extended value per cell
+ * Returns false if the queue is empty
+ */
+bool readHx711ArraySamples(int32_t values[HX711_ARRAY_CELLS])
+{
+    const HX711_ARRAY_FRAME *entry;
+    uint32_t value[HX711_ARRAY_CELLS];
+    uint8_t bits;
+    uint8_t i;
+    uint8_t j;
+
+    if (queueReadIndex == queueWriteIndex)
+        return false;
+    entry = &queue[queueReadIndex];
+
+    for (j = 0; j < HX711_ARRAY_CELLS; j++)
+        value[j] = 0;
+    for (i = 0; i < 24; i++)
+    {
+        bits = entry->bits[i];
+        for (j = 0; j < HX711_ARRAY_CELLS; j++)
+            value[j] = (value[j] << 1) | ((bits >> j) & 1);
+    }
+    for (j = 0; j < HX711_ARRAY_CELLS; j++)
+        values[j] = (int32_t)(value[j] << 8) >> 8;
+
+    queueReadIndex = (queueReadIndex + 1) & (HX711_ARRAY_QUEUE_SIZE - 1);
+    return true;
+}
+
+// Number of conversions lost because the queue was full
+uint32_t getHx711ArrayOverflowCount(void)
+{
+    return overflowCount;
+}
+
+// GPIO Port E interrupt: a DOUT fell, start once the last cell is ready
+void hx711ArrayReadyIsr(void)
+{
+    GPIO_PORTE_ICR_R = DATA_MASK;
+    startRead();
+}
+
+// Timer 2A interrupt: one PD_SCK edge per tick, DOUT is sampled just before each falling edge
+void hx711ArrayClockIsr(void)
+{
+    uint8_t next;
+
+    TIMER2_ICR_R = TIMER_ICR_TATOCINT;
+    if (!clockHigh)
+    {
+        setPinValue(HX711_ARRAY_CLK, 1);
+        clockHigh = true;
+        return;
+    }
+
+    if (pulse < 24)
+        frame.bits[pulse] = getPortValue(PORTE);
+    setPinValue(HX711_ARRAY_CLK, 0);
+    clockHigh = false;
+    if (++pulse < readGain)
+        return;
+
+    // Last gain pulse sent
+    TIMER2_CTL_R &= ~TIMER_CTL_TAEN;
+    if (conversionGain == gain)
+    {
+        next = (queueWriteIndex + 1) & (HX711_ARRAY_QUEUE_SIZE - 1);
+        if (next == queueReadIndex)
+        {
+            overflowCount++;
+        }
+        else
+        {
+            queue[queueWriteIndex] = frame;
+            queueWriteIndex = next;
+        }
+    }
+    conversionGain = readGain;
+
+    GPIO_PORTE_ICR_R = DATA_MASK;                    // edges seen while the bits were shifted out
+    GPIO_PORTE_IM_R |= DATA_MASK;
+    startRead();                                     // in case every cell is already ready again
+}
@@ -0,0 +1,46 @@
+// HX711 Array Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// Up to 4 HX711 load cell ADCs read in parallel:
+//   DOUT of cell n on PEn (PE0-PE3), shared PD_SCK on PE4, shared RATE on PE5
+//   Timer 2A paces PD_SCK at 250 kHz, each high phase samples every DOUT with one port read
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef HX711ARRAY_H_
+#define HX711ARRAY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hx711.h"
+
+// Cells fitted (1-4), their DOUT lines start at PE0
+#define HX711_ARRAY_CELLS 4
+
+// Conversions held until the main loop reads them (size must be a power of 2)
+#define HX711_ARRAY_QUEUE_SIZE 8
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initHx711Array(void);
+void setHx711ArrayInterruptPriority(uint8_t priority);
+void setHx711ArrayGain(HX711_GAIN gain);
+void setHx711ArrayRate(HX711_RATE rate);
+bool readHx711ArraySamples(int32_t values[HX711_ARRAY_CELLS]);
+uint32_t getHx711ArrayOverflowCount(void);
+void hx711ArrayReadyIsr(void);
+void hx711ArrayClockIsr(void);
+
+#endif
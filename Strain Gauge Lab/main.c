@@ -2,22 +2,67 @@
  * Antonio Buentello
  */
 
-#include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
+#ifdef BENCHMARK_FORMAT
+#include <stdio.h>
+#endif
 #include "wait.h"
 #include "uart0.h"
 #include "tm4c123gh6pm.h"
 #include "gpio.h"
 #include "clock.h"
 #include "nvic.h"
+#include "format.h"
+#include "telemetry.h"
+#include "command.h"
+#include "hx711.h"
+#include "hx711array.h"
+#include "filter.h"
+#include "eeprom.h"
+#include "capture.h"
+
+// Define HX711_ARRAY to read HX711_ARRAY_CELLS load cells in parallel instead of one on SSI0
 
-#define CLK PORTF,1
-#define DATA PORTF,2
+// Text output shows every nth conversion, binary records carry all of them
+#define TEXT_DECIMATION 8
+
+// A finished capture is uploaded one record of CAPTURE_CHUNK samples every
+// UPLOAD_DECIMATION conversions, which keeps the link within 115200 baud at 80 SPS
+#define CAPTURE_CHUNK 32
+#define UPLOAD_DECIMATION 4
+#define DEFAULT_PRE_TRIGGER 128
 
 int32_t dataIn = 0;
+uint32_t average = 0;
+
+// Settling filter thresholds in hx711 counts (about 60 counts per gram)
+// A jump of more than STEP_THRESHOLD restarts the average, the reading is
+// stable once the newest samples agree within STABLE_THRESHOLD
+#define STEP_THRESHOLD 600
+#define STABLE_THRESHOLD 120
+
+SETTLING_FILTER weightFilter;
 
-uint32_t array[16];
+uint16_t uploadIndex = 0;
+
+// weight = (average - zero) * scale / 65536, in units of 1e-4 g
+// The defaults are the original fit, weight = -0.0167 * average + 203404
+#define DEFAULT_ZERO 12179880
+#define DEFAULT_SCALE -10944512
+
+typedef struct _CALIBRATION
+{
+    int32_t zero;                                    // counts with no load
+    int32_t scale;                                   // 1e-4 g per count, Q16
+} CALIBRATION;
+
+CALIBRATION calibration = {DEFAULT_ZERO, DEFAULT_SCALE};
+
+// First point of a two-point calibration, held until the second is taken
+bool calibrationPointTaken = false;
+int32_t calibrationPointCounts;
+int32_t calibrationPointWeight;
 
 void initHw()
 {
@@ -25,93 +70,401 @@ void initHw()
     initUart0();
     setUart0BaudRate(115200, 40e6);
 
-    enablePort(PORTF);
+#ifdef HX711_ARRAY
+    initHx711Array();
 
-    selectPinPushPullOutput(CLK);
+    // The PD_SCK tick must not be held off long enough to power the cells down
+    setHx711ArrayInterruptPriority(0);
+    setNvicInterruptPriority(INT_UART0, 1);
+#else
+    initHx711();
 
-    disablePinInterrupt(DATA);
-    selectPinDigitalInput(DATA);
-    enablePinPulldown(DATA);
-    selectPinInterruptFallingEdge(DATA);
-    enableNvicInterrupt(INT_GPIOF);
-    enablePinInterrupt(DATA);
+    // Conversions are read well within a sample period, so the console keeps priority
+    setNvicInterruptPriority(INT_UART0, 1);
+    setHx711InterruptPriority(2);
+#endif
 }
 
-void dataIsr(void)
+void setGain(HX711_GAIN gain)
 {
-    uint8_t i;
+#ifdef HX711_ARRAY
+    setHx711ArrayGain(gain);
+#else
+    setHx711Gain(gain);
+#endif
+}
+
+void setRate(HX711_RATE rate)
+{
+#ifdef HX711_ARRAY
+    setHx711ArrayRate(rate);
+#else
+    setHx711Rate(rate);
+#endif
+}
+
 
-    dataIn = 0;
-    char str[10];
+// Returns the weight in units of 1e-4 g
+int32_t getWeight(uint32_t average)
+{
+    return (int64_t)((int32_t)average - calibration.zero) * calibration.scale / 65536;
+}
 
-    for(i = 0; i < 24; i++)
+void loadCalibration()
+{
+    uint32_t record[2];
+    if (loadEepromRecord(EEPROM_BLOCK_STRAIN_CALIBRATION, record, 2))
     {
-        waitMicrosecond(1);
-        setPinValue(CLK, 1);
-        waitMicrosecond(1);
-        dataIn <<= 1;
-        dataIn |= getPinValue(DATA);
-        setPinValue(CLK, 0);
+        calibration.zero = record[0];
+        calibration.scale = record[1];
     }
-    waitMicrosecond(1);
-    setPinValue(CLK, 1);
-    waitMicrosecond(1);
-    setPinValue(CLK, 0);
-    clearPinInterrupt(DATA);
 }
 
+void saveCalibration()
+{
+    uint32_t record[2];
+    record[0] = calibration.zero;
+    record[1] = calibration.scale;
+    if (saveEepromRecord(EEPROM_BLOCK_STRAIN_CALIBRATION, record, 2))
+        putsUart0("Calibration saved\n");
+    else
+        putsUart0("EEPROM write failed\n");
+}
 
-int main(void)
+// force = 9.81 * weight / 1000, in units of 1e-4 N
+int32_t getForce(int32_t weight)
+{
+    return (int64_t)weight * 981 / 100000;
+}
+
+#ifdef BENCHMARK_FORMAT
+// SysTick cycles elapsed since start (24-bit down counter at the system clock)
+uint32_t elapsedCycles(uint32_t start)
 {
+    return (start - NVIC_ST_CURRENT_R) & NVIC_ST_RELOAD_M;
+}
 
-    initHw();
+// Compares the cost of queueing the weight and force lines with sprintf and with putFixedUart0
+void benchmarkFormat(uint32_t average)
+{
     char str[35];
-    uint32_t sum = 0;
-    uint8_t index = 0;
-    uint32_t average= 0;
-    uint8_t i;
+    float weight;
+    uint32_t start;
+    uint32_t sprintfCycles;
+    uint32_t formatCycles;
 
-    float force=0;
-    float weight = 0;
+    NVIC_ST_CTRL_R = 0;
+    NVIC_ST_RELOAD_R = NVIC_ST_RELOAD_M;
+    NVIC_ST_CURRENT_R = 0;
+    NVIC_ST_CTRL_R = NVIC_ST_CTRL_CLK_SRC | NVIC_ST_CTRL_ENABLE;
 
-    for (i = 0; i < 16; i++)
-        array[i] = 0;
+    flushUart0();
+    start = NVIC_ST_CURRENT_R;
+    weight = (-0.0167 * average) + 203404;
+    putsUart0("Calculated Weight (Grams): ");
+    sprintf(str, "%.4f", weight);
+    putsUart0(str);
+    putsUart0("\nCalculated FORCE (N): ");
+    sprintf(str, "%.4f", 9.81 * (weight / 1000));
+    putsUart0(str);
+    putsUart0("\n\n");
+    sprintfCycles = elapsedCycles(start);
 
-    while(1)
+    flushUart0();
+    start = NVIC_ST_CURRENT_R;
+    putsUart0("Calculated Weight (Grams): ");
+    putFixedUart0(getWeight(average), 4);
+    putsUart0("\nCalculated FORCE (N): ");
+    putFixedUart0(getForce(getWeight(average)), 4);
+    putsUart0("\n\n");
+    formatCycles = elapsedCycles(start);
+
+    flushUart0();
+    putsUart0("sprintf cycles: ");
+    putDecUart0(sprintfCycles, 7);
+    putsUart0("\nformat cycles:  ");
+    putDecUart0(formatCycles, 7);
+    putsUart0("\n\n");
+    NVIC_ST_CTRL_R = 0;
+}
+#endif
+
+// Console commands, dispatched through the hashed table in command.c
+void binaryCommand(const COMMAND_ARGS *args)
+{
+    setTelemetryMode(TELEMETRY_BINARY);
+}
+
+void textCommand(const COMMAND_ARGS *args)
+{
+    setTelemetryMode(TELEMETRY_TEXT);
+}
+
+// gain 128 | 64 selects channel A, gain 32 selects channel B
+void gainCommand(const COMMAND_ARGS *args)
+{
+    if (args->integer[0] == 128)
+        setGain(HX711_A_128);
+    else if (args->integer[0] == 64)
+        setGain(HX711_A_64);
+    else if (args->integer[0] == 32)
+        setGain(HX711_B_32);
+    else
+        putsUart0("Gain is 128, 64 or 32\n");
+}
+
+// rate 10 | 80 (samples per second)
+void rateCommand(const COMMAND_ARGS *args)
+{
+    if (args->integer[0] == 80)
+        setRate(HX711_RATE_80SPS);
+    else
+        setRate(HX711_RATE_10SPS);
+}
+
+// Calibration points are only taken from a settled reading
+bool isReadingStable()
+{
+    if (isSettlingFilterStable(&weightFilter))
+        return true;
+    putsUart0("Reading is not stable\n");
+    return false;
+}
+
+// tare: the current load reads zero
+void tareCommand(const COMMAND_ARGS *args)
+{
+    if (!isReadingStable())
+        return;
+    calibration.zero = average;
+    saveCalibration();
+}
+
+// cal GRAMS: takes a point with a known weight, the second point sets zero and scale
+// cal: shows the calibration
+void calCommand(const COMMAND_ARGS *args)
+{
+    int32_t counts = average;
+    int32_t weight;
+    int64_t scale;
+
+    if (args->count == 0)
+    {
+        putsUart0("Zero: ");
+        putIntUart0(calibration.zero, 0);
+        putsUart0(" counts, scale: ");
+        putFixedUart0((int64_t)calibration.scale * 10000 / 65536, 4);
+        putsUart0(" (1e-4 g per count)\n");
+        return;
+    }
+    if (!isReadingStable())
+        return;
+    weight = args->integer[0] * 10000;
+    if (!calibrationPointTaken)
+    {
+        calibrationPointCounts = counts;
+        calibrationPointWeight = weight;
+        calibrationPointTaken = true;
+        putsUart0("Point taken, change the weight and cal again\n");
+        return;
+    }
+    calibrationPointTaken = false;
+    if (counts == calibrationPointCounts || weight == calibrationPointWeight)
+    {
+        putsUart0("Points must differ\n");
+        return;
+    }
+    scale = ((int64_t)(weight - calibrationPointWeight) * 65536) / (counts - calibrationPointCounts);
+    if (scale == 0 || scale > INT32_MAX || scale < INT32_MIN)
     {
-        waitMicrosecond(100000);
+        putsUart0("Scale out of range\n");
+        return;
+    }
+    calibration.scale = scale;
+    calibration.zero = counts - (int64_t)weight * 65536 / scale;
+    saveCalibration();
+}
 
-        sum -= array[index];
-        sum += dataIn;
-        array[index] = dataIn;
-        index = (index + 1) & 15;
+// filter STEP STABLE (hx711 counts)
+void filterCommand(const COMMAND_ARGS *args)
+{
+    int32_t stable = STABLE_THRESHOLD;
+    if (args->count > 1)
+        stable = args->integer[1];
+    initSettlingFilter(&weightFilter, args->integer[0], stable);
+}
 
-        average = (sum >> 4);
+// capture level|slope THRESHOLD [PRE] arms a capture of raw samples (hx711 counts)
+// capture stop discards it
+void captureCommand(const COMMAND_ARGS *args)
+{
+    uint16_t preTrigger = DEFAULT_PRE_TRIGGER;
 
-        putsUart0("RAW: ");
-        sprintf(str, "%d", dataIn);
-        putsUart0(str);
-        putsUart0("\n");
+    if (strCmp(args->string[0], "stop") == 0)
+    {
+        stopCapture();
+        return;
+    }
+    if (args->count < 2)
+    {
+        putCommandStatusUart0(COMMAND_MISSING_ARGUMENT);
+        return;
+    }
+    if (args->count > 2)
+        preTrigger = args->integer[2];
+    if (strCmp(args->string[0], "level") == 0)
+        armCapture(CAPTURE_LEVEL, args->integer[1], preTrigger);
+    else if (strCmp(args->string[0], "slope") == 0)
+        armCapture(CAPTURE_SLOPE, args->integer[1], preTrigger);
+    else
+    {
+        putsUart0("Trigger is level or slope\n");
+        return;
+    }
+    uploadIndex = 0;
+}
 
-        putsUart0("Filtered: ");
-        sprintf(str, "%d", average);
-        putsUart0(str);
-        putsUart0("\n");
+// Sends the next part of a finished capture, then releases it once all samples are sent
+// Starts with the trigger position, each record then leads with the index of its first sample
+void uploadCapture()
+{
+    int32_t record[CAPTURE_CHUNK + 1];
+    uint32_t info[2];
+
+    if (uploadIndex == 0)
+    {
+        info[0] = getCaptureTriggerIndex();
+        info[1] = CAPTURE_SIZE;
+        sendTelemetry(TELEMETRY_STRAIN_CAPTURE_INFO, TELEMETRY_U32, info, 2);
+    }
+    record[0] = uploadIndex;
+    uploadIndex += readCapture(&record[1], uploadIndex, CAPTURE_CHUNK);
+    sendTelemetry(TELEMETRY_STRAIN_CAPTURE, TELEMETRY_I32, record, uploadIndex - record[0] + 1);
+    if (uploadIndex == CAPTURE_SIZE)
+        stopCapture();
+}
+
+const COMMAND commands[] =
+{
+    {"binary", 0, "", binaryCommand},
+    {"text", 0, "", textCommand},
+    {"gain", 1, "n", gainCommand},
+    {"rate", 1, "n", rateCommand},
+    {"filter", 1, "nn", filterCommand},
+    {"tare", 0, "", tareCommand},
+    {"cal", 0, "n", calCommand},
+    {"capture", 1, "ann", captureCommand}
+};
+
+void processCommand(USER_DATA *data)
+{
+    COMMAND_STATUS status = runCommand(data);
+    if (getTelemetryMode() == TELEMETRY_TEXT)
+        putCommandStatusUart0(status);
+}
+
+int main(void)
+{
+
+    initHw();
+    initTelemetry();
+    startUart0LineInput();
+    if (!initCommands(commands, sizeof(commands) / sizeof(commands[0])))
+        putsUart0("Command table init failed\n");
+    USER_DATA data;
+    uint8_t settling[2];
+    uint8_t printCount = 0;
+    uint8_t uploadCount = 0;
+    int32_t sample;
+#ifdef HX711_ARRAY
+    int32_t cells[HX711_ARRAY_CELLS];
+    uint8_t i;
+#endif
+
+    int32_t force = 0;
+    int32_t weight = 0;
+
+    initSettlingFilter(&weightFilter, STEP_THRESHOLD, STABLE_THRESHOLD);
+    if (initEeprom())
+        loadCalibration();
+
+    setRate(HX711_RATE_80SPS);
+
+#ifdef BENCHMARK_FORMAT
+    // Timed once on the first conversion, before binary mode can be selected
+#ifdef HX711_ARRAY
+    while (!readHx711ArraySamples(cells));
+    sample = cells[0];
+#else
+    while (!readHx711Sample(&sample));
+#endif
+    benchmarkFormat(sample & 0xFFFFFF);
+#endif
+
+    while(1)
+    {
+        if (getUart0Line(&data))
+            processCommand(&data);
+#ifdef HX711_ARRAY
+        if (!readHx711ArraySamples(cells))
+            continue;
+        sample = cells[0];                           // the weight fit is for a single cell
+#else
+        if (!readHx711Sample(&sample))
+            continue;
+#endif
 
+        // The weight calibration was fitted to the unsigned 24-bit reading
+        dataIn = sample & 0xFFFFFF;
+        if (addCaptureSample(dataIn) && getTelemetryMode() == TELEMETRY_TEXT)
+            putsUart0("Capture complete, send binary to upload\n");
+        average = updateSettlingFilter(&weightFilter, dataIn);
+        settling[0] = isSettlingFilterStable(&weightFilter);
+        settling[1] = getSettlingFilterWindow(&weightFilter);
+        weight = getWeight(average);
+        force = getForce(weight);
 
-        weight = (-0.0167 * average) + 203404;
+        printCount = (printCount + 1) % TEXT_DECIMATION;
+        if (getTelemetryMode() == TELEMETRY_TEXT && printCount == 0)
+        {
+            putsUart0("RAW: ");
+            putIntUart0(dataIn, 0);
+            putsUart0("\n");
 
-        putsUart0("Calculated Weight (Grams): ");
-        sprintf(str, "%.4f", weight);
-        putsUart0(str);
-        putsUart0("\n");
+            putsUart0("Filtered: ");
+            putIntUart0(average, 0);
+            putsUart0(settling[0] ? " (stable, " : " (settling, ");
+            putIntUart0(settling[1], 0);
+            putsUart0(" samples)\n");
 
-        force = (9.81 * (weight / 1000));
+            putsUart0("Calculated Weight (Grams): ");
+            putFixedUart0(weight, 4);
+            putsUart0("\n");
 
-        putsUart0("Calculated FORCE (N): ");
-        sprintf(str, "%.4f", force);
-        putsUart0(str);
-        putsUart0("\n\n");
+            putsUart0("Calculated FORCE (N): ");
+            putFixedUart0(force, 4);
+            putsUart0("\n\n");
+#ifdef HX711_ARRAY
+            putsUart0("Cells:");
+            for (i = 0; i < HX711_ARRAY_CELLS; i++)
+            {
+                putcUart0(' ');
+                putIntUart0(cells[i], 0);
+            }
+            putsUart0("\n\n");
+#endif
+        }
+        sendTelemetry(TELEMETRY_STRAIN_RAW, TELEMETRY_I32, &dataIn, 1);
+        sendTelemetry(TELEMETRY_STRAIN_FILTERED, TELEMETRY_U32, &average, 1);
+        sendTelemetry(TELEMETRY_STRAIN_WEIGHT, TELEMETRY_I32, &weight, 1);
+        sendTelemetry(TELEMETRY_STRAIN_FORCE, TELEMETRY_I32, &force, 1);
+        sendTelemetry(TELEMETRY_STRAIN_SETTLING, TELEMETRY_U8, settling, 2);
+        uploadCount = (uploadCount + 1) % UPLOAD_DECIMATION;
+        if (getCaptureState() == CAPTURE_DONE && getTelemetryMode() == TELEMETRY_BINARY && uploadCount == 0)
+            uploadCapture();
+#ifdef HX711_ARRAY
+        sendTelemetry(TELEMETRY_STRAIN_CELLS, TELEMETRY_I32, cells, HX711_ARRAY_CELLS);
+#endif
 
 
     }
@@ -0,0 +1,95 @@
+// Telemetry Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// Records are written through putcUart0
+// Wide Timer 5A free-runs at 1 MHz as the record timestamp
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Binary record, little endian, before framing
+ *  byte 0       : channel id
+ *  byte 1       : payload element type
+ *  byte 2-5     : timestamp (us)
+ *  byte 6-n     : payload, an array of elements of the given type
+ *  byte n+1-n+2 : CRC-16/CCITT-FALSE of bytes 0-n
+ * Each record is COBS encoded and followed by a 0x00 delimiter
+ */
+#define TELEMETRY_HEADER_SIZE 6
+#define TELEMETRY_MAX_PAYLOAD 240
+
+typedef enum _TELEMETRY_MODE
+{
+    TELEMETRY_TEXT,
+    TELEMETRY_BINARY
+} TELEMETRY_MODE;
+
+typedef enum _TELEMETRY_TYPE
+{
+    TELEMETRY_U8 = 1,
+    TELEMETRY_I8 = 2,
+    TELEMETRY_U16 = 3,
+    TELEMETRY_I16 = 4,
+    TELEMETRY_U32 = 5,
+    TELEMETRY_I32 = 6,
+    TELEMETRY_F32 = 7
+} TELEMETRY_TYPE;
+
+// Channel ids and payload units, shared by all labs so one host decoder reads every board
+typedef enum _TELEMETRY_CHANNEL
+{
+    TELEMETRY_STRAIN_RAW = 1,                        // hx711 counts
+    TELEMETRY_STRAIN_FILTERED = 2,                   // hx711 counts
+    TELEMETRY_STRAIN_WEIGHT = 3,                     // 1e-4 g
+    TELEMETRY_STRAIN_FORCE = 4,                      // 1e-4 N
+    TELEMETRY_STRAIN_CELLS = 5,                      // hx711 counts, one per load cell
+    TELEMETRY_STRAIN_SETTLING = 6,                   // u8 stable flag, u8 averaging window
+    TELEMETRY_STRAIN_CAPTURE = 7,                    // first index, then raw hx711 counts
+    TELEMETRY_STRAIN_CAPTURE_INFO = 8,               // u32 trigger index, u32 samples in the capture
+    TELEMETRY_FREQUENCY = 16,                        // Hz
+    TELEMETRY_RPM = 17,                              // rpm
+    TELEMETRY_BACK_EMF_RPM = 18,                     // rpm
+    TELEMETRY_BACK_EMF_RAW = 19,                     // adc counts
+    TELEMETRY_PWM = 20,                              // compare value
+    TELEMETRY_COMMUTATION_DELAY = 21,                // us
+    TELEMETRY_FREQUENCY_FINE = 22,                   // mHz
+    TELEMETRY_METAL_DETECTOR = 23,                   // baseline mHz, deviation mHz, strength %, detected
+    TELEMETRY_METAL_GOERTZEL = 24,                   // coil and drive amplitude (1e-3 counts), phase (1e-3 deg), filter cycles
+    TELEMETRY_MOTOR_CURRENT_RAW = 25,                // adc counts at the back-emf sample
+    TELEMETRY_SPEED_SETPOINT = 26,                   // rpm, while the speed loop is closed
+    TELEMETRY_BACK_EMF_FIT = 27,                     // quadratic (1e9), slope and intercept (1e4)
+    TELEMETRY_BACK_EMF_CAL_POINT = 28,               // pwm, tach rpm, mean analog of a calibration step
+    TELEMETRY_TMP36_RAW = 32,                        // ads1115 counts
+    TELEMETRY_THERMOCOUPLE_RAW = 33,                 // ads1115 counts
+    TELEMETRY_TEMPERATURE = 34,                      // C
+    TELEMETRY_LIDAR_SCAN = 48,                       // first one degree bin, then distance q2 per bin
+    TELEMETRY_LIDAR_DROPPED = 49                     // revolutions dropped while one was being sent, total
+} TELEMETRY_CHANNEL;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initTelemetry(void);
+void setTelemetryMode(TELEMETRY_MODE mode);
+TELEMETRY_MODE getTelemetryMode(void);
+uint32_t getTelemetryTimestamp(void);
+void sendTelemetry(uint8_t channel, TELEMETRY_TYPE type, const void *payload, uint8_t count);
+
+#endif
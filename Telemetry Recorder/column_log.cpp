@@ -0,0 +1,312 @@
+// Column Log Library
+
+//-----------------------------------------------------------------------------
+// Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: Linux host
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "column_log.h"
+
+// Files start at 1 MiB and double up to 64 MiB per growth step
+#define COLUMN_INITIAL_SIZE (1 << 20)
+#define COLUMN_MAX_GROWTH (64 << 20)
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// Channel ids from telemetry.h
+static const ChannelLayout layouts[] =
+{
+    {1,  "strain_raw",        0, 1, {"value"}},
+    {2,  "strain_filtered",   0, 1, {"value"}},
+    {3,  "strain_weight",     0, 1, {"value"}},
+    {4,  "strain_force",      0, 1, {"value"}},
+    {5,  "strain_cells",      0, 4, {"cell0", "cell1", "cell2", "cell3"}},
+    {6,  "strain_settling",   0, 2, {"stable", "window"}},
+    {7,  "strain_capture",    1, 1, {"value"}},
+    {8,  "strain_capture_info", 0, 2, {"trigger_index", "samples"}},
+    {16, "frequency",         0, 1, {"value"}},
+    {17, "rpm",               0, 1, {"value"}},
+    {18, "back_emf_rpm",      0, 1, {"value"}},
+    {19, "back_emf_raw",      0, 1, {"value"}},
+    {20, "pwm",               0, 1, {"value"}},
+    {21, "commutation_delay", 0, 1, {"value"}},
+    {22, "frequency_fine",    0, 1, {"value"}},
+    {23, "metal_detector",    0, 4, {"baseline", "deviation", "strength", "detected"}},
+    {24, "metal_goertzel",    0, 4, {"amplitude", "reference", "phase", "cycles"}},
+    {25, "motor_current_raw", 0, 1, {"value"}},
+    {26, "speed_setpoint",    0, 1, {"value"}},
+    {27, "back_emf_fit",      0, 3, {"quadratic", "slope", "intercept"}},
+    {28, "back_emf_cal_point", 0, 3, {"pwm", "rpm", "analog"}},
+    {32, "tmp36_raw",         0, 1, {"value"}},
+    {33, "thermocouple_raw",  0, 1, {"value"}},
+    {34, "temperature",       0, 1, {"value"}},
+    {48, "lidar_scan",        1, 1, {"distance_q2"}},
+    {49, "lidar_dropped",     0, 1, {"value"}}
+};
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+const ChannelLayout *findChannelLayout(uint8_t channel)
+{
+    size_t i;
+    for (i = 0; i < sizeof(layouts) / sizeof(layouts[0]); i++)
+    {
+        if (layouts[i].channel == channel)
+            return &layouts[i];
+    }
+    return nullptr;
+}
+
+ColumnFile::ColumnFile()
+    : fd(-1), map(nullptr), mapped(0), used(0), rows(0), type(0), size(0)
+{
+}
+
+ColumnFile::~ColumnFile()
+{
+    close();
+}
+
+bool ColumnFile::open(const std::string &path, uint8_t newType)
+{
+    close();
+    type = newType;
+    size = getTelemetryTypeSize(newType);
+    rows = 0;
+    used = COLUMN_HEADER_SIZE;
+    mapped = COLUMN_INITIAL_SIZE;
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        fprintf(stderr, "%s: %s\n", path.c_str(), strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, mapped) != 0)
+    {
+        fprintf(stderr, "%s: %s\n", path.c_str(), strerror(errno));
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    void *address = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED)
+    {
+        fprintf(stderr, "%s: %s\n", path.c_str(), strerror(errno));
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    map = static_cast<uint8_t *>(address);
+
+    memcpy(map, "TLMC", 4);
+    map[4] = 1;
+    map[5] = type;
+    map[6] = size;
+    map[7] = 0;
+    writeRows();
+    return true;
+}
+
+// Trim the file to the rows written and release the mapping
+void ColumnFile::close()
+{
+    if (map != nullptr)
+    {
+        munmap(map, mapped);
+        map = nullptr;
+    }
+    if (fd >= 0)
+    {
+        if (ftruncate(fd, used) != 0)
+            perror("ftruncate");
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+bool ColumnFile::grow()
+{
+    size_t growth = mapped < COLUMN_MAX_GROWTH ? mapped : COLUMN_MAX_GROWTH;
+    size_t newSize = mapped + growth;
+    void *address;
+
+    if (ftruncate(fd, newSize) != 0)
+    {
+        perror("ftruncate");
+        return false;
+    }
+    address = mremap(map, mapped, newSize, MREMAP_MAYMOVE);
+    if (address == MAP_FAILED)
+    {
+        perror("mremap");
+        return false;
+    }
+    map = static_cast<uint8_t *>(address);
+    mapped = newSize;
+    return true;
+}
+
+void ColumnFile::writeRows()
+{
+    uint8_t i;
+    for (i = 0; i < 8; i++)
+        map[8 + i] = rows >> (8 * i);
+}
+
+ColumnLog::ColumnLog(const std::string &outputDirectory)
+    : directory(outputDirectory), channels(new Channel[256]()), lastTimestamp(0),
+      haveTimestamp(false), stats()
+{
+}
+
+ColumnLog::~ColumnLog()
+{
+    close();
+}
+
+void ColumnLog::close()
+{
+    int i;
+    uint8_t j;
+    for (i = 0; i < 256; i++)
+    {
+        Channel &channel = channels[i];
+        channel.time.close();
+        channel.index.close();
+        for (j = 0; j < COLUMN_MAX_COLUMNS; j++)
+            channel.value[j].close();
+    }
+}
+
+// The board timestamp wraps every 2^32 us, all channels share one clock so unwrap once here
+uint64_t ColumnLog::extendTimestamp(uint32_t timestamp)
+{
+    uint32_t delta;
+    if (!haveTimestamp)
+    {
+        lastTimestamp = timestamp;
+        haveTimestamp = true;
+        return lastTimestamp;
+    }
+    delta = timestamp - static_cast<uint32_t>(lastTimestamp);
+    if (delta < 0x80000000)
+        lastTimestamp += delta;                      // forward, possibly across a wrap
+    else
+        return lastTimestamp - (0x100000000ULL - delta);  // slightly out of order, keep the clock
+    return lastTimestamp;
+}
+
+bool ColumnLog::openChannel(Channel &channel, const TelemetryRecord &record)
+{
+    const ChannelLayout *layout = findChannelLayout(record.channel);
+    char generic[16];
+    std::string path;
+    uint8_t i;
+    bool ok;
+
+    if (layout != nullptr)
+    {
+        channel.layout = *layout;
+    }
+    else
+    {
+        snprintf(generic, sizeof(generic), "channel_%u", record.channel);
+        channel.layout = {record.channel, nullptr, 0, 1, {"value"}};
+    }
+
+    path = directory + "/" + (layout != nullptr ? layout->name : generic);
+    if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        fprintf(stderr, "%s: %s\n", path.c_str(), strerror(errno));
+        return false;
+    }
+
+    channel.type = record.type;
+    ok = channel.time.open(path + "/time.col", TELEMETRY_U64);
+    if (channel.layout.headerElements != 0)
+        ok = ok && channel.index.open(path + "/index.col", TELEMETRY_U32);
+    for (i = 0; i < channel.layout.columns; i++)
+        ok = ok && channel.value[i].open(path + "/" + channel.layout.columnNames[i] + ".col", record.type);
+    return ok;
+}
+
+void ColumnLog::write(const TelemetryRecord &record)
+{
+    Channel &channel = channels[record.channel];
+    const ChannelLayout &layout = channel.layout;
+    uint64_t time = extendTimestamp(record.timestamp);
+    uint8_t size = getTelemetryTypeSize(record.type);
+    const uint8_t *element;
+    uint32_t firstRow = 0;
+    uint32_t row;
+    uint16_t rowCount;
+    uint16_t i;
+    uint8_t j;
+    bool ok = true;
+
+    if (channel.failed)
+        return;
+    if (!channel.opened)
+    {
+        channel.opened = true;
+        if (!openChannel(channel, record))
+        {
+            channel.failed = true;
+            stats.writeErrors++;
+            return;
+        }
+    }
+
+    if (record.type != channel.type || record.count < layout.headerElements
+        || (record.count - layout.headerElements) % layout.columns != 0)
+    {
+        stats.layoutErrors++;
+        return;
+    }
+
+    // The leading element is the index of the first row, widened to u32
+    element = record.payload;
+    if (layout.headerElements != 0)
+    {
+        for (j = 0; j < size; j++)
+            firstRow |= static_cast<uint32_t>(element[j]) << (8 * j);
+        element += size;
+    }
+
+    rowCount = (record.count - layout.headerElements) / layout.columns;
+    for (i = 0; i < rowCount; i++)
+    {
+        ok = ok && channel.time.append(&time);
+        if (layout.headerElements != 0)
+        {
+            row = firstRow + i;
+            ok = ok && channel.index.append(&row);
+        }
+        for (j = 0; j < layout.columns; j++)
+        {
+            ok = ok && channel.value[j].append(element);
+            element += size;
+        }
+    }
+    if (ok)
+        stats.rows += rowCount;
+    else
+        stats.writeErrors++;
+}
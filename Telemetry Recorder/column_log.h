@@ -0,0 +1,143 @@
+// Column Log Library
+
+//-----------------------------------------------------------------------------
+// Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: Linux host
+
+// Each channel is written to its own directory of column files, one file per column:
+//   <output>/<channel>/time.col   extended timestamp (us, u64)
+//   <output>/<channel>/value.col  payload elements in the type sent by the board
+// Lidar scan records are split into index (one degree bin) and distance_q2 columns
+// Strain cell records are split into one column per load cell
+// Strain settling records are split into stable and window columns
+// Strain capture records are split into index and value columns like lidar scans
+//
+// Column file layout (little endian):
+//  byte 0-3   : "TLMC"
+//  byte 4     : version (1)
+//  byte 5     : element type (TelemetryType)
+//  byte 6     : element size (bytes)
+//  byte 7     : reserved
+//  byte 8-15  : row count, updated as rows are appended
+//  byte 16-   : rows
+// Files are mapped and grown in chunks, then trimmed to the row count when closed
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef COLUMN_LOG_H_
+#define COLUMN_LOG_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <memory>
+#include <string>
+#include "frame_decoder.h"
+
+#define COLUMN_HEADER_SIZE 16
+#define COLUMN_MAX_COLUMNS 4
+
+class ColumnFile
+{
+public:
+    ColumnFile();
+    ~ColumnFile();
+    ColumnFile(const ColumnFile &) = delete;
+    ColumnFile &operator=(const ColumnFile &) = delete;
+
+    bool open(const std::string &path, uint8_t type);
+    void close();
+    bool isOpen() const { return map != nullptr; }
+
+    // Append one element of the column type, returns false if the file could not grow
+    bool append(const void *element)
+    {
+        if (used + size > mapped && !grow())
+            return false;
+        copyElement(map + used, static_cast<const uint8_t *>(element));
+        used += size;
+        rows++;
+        writeRows();
+        return true;
+    }
+
+    uint8_t getType() const { return type; }
+    uint64_t getRows() const { return rows; }
+
+private:
+    bool grow();
+    void writeRows();
+    void copyElement(uint8_t *destination, const uint8_t *source) const
+    {
+        uint8_t i;
+        for (i = 0; i < size; i++)
+            destination[i] = source[i];
+    }
+
+    int fd;
+    uint8_t *map;
+    size_t mapped;                                   // bytes mapped (file size while open)
+    size_t used;                                     // header plus rows
+    uint64_t rows;
+    uint8_t type;
+    uint8_t size;
+};
+
+// Column layout of one channel: leading header elements, then rows of columns
+struct ChannelLayout
+{
+    uint8_t channel;
+    const char *name;
+    uint8_t headerElements;                          // 1 when the record starts with the index of its first row
+    uint8_t columns;
+    const char *columnNames[COLUMN_MAX_COLUMNS];
+};
+
+const ChannelLayout *findChannelLayout(uint8_t channel);
+
+struct ColumnLogStats
+{
+    uint64_t rows;
+    uint64_t layoutErrors;                           // type changed or count does not fit the layout
+    uint64_t writeErrors;
+};
+
+// Recorder for all channels, channel directories are created on the first record
+class ColumnLog
+{
+public:
+    explicit ColumnLog(const std::string &directory);
+    ~ColumnLog();
+    ColumnLog(const ColumnLog &) = delete;
+    ColumnLog &operator=(const ColumnLog &) = delete;
+
+    void write(const TelemetryRecord &record);
+    void close();
+    const ColumnLogStats &getStats() const { return stats; }
+
+private:
+    struct Channel
+    {
+        bool opened;
+        bool failed;
+        ChannelLayout layout;
+        uint8_t type;
+        ColumnFile time;
+        ColumnFile index;
+        ColumnFile value[COLUMN_MAX_COLUMNS];
+    };
+
+    bool openChannel(Channel &channel, const TelemetryRecord &record);
+    uint64_t extendTimestamp(uint32_t timestamp);
+
+    std::string directory;
+    std::unique_ptr<Channel[]> channels;             // one per channel id
+    uint64_t lastTimestamp;
+    bool haveTimestamp;
+    ColumnLogStats stats;
+};
+
+#endif
@@ -0,0 +1,149 @@
+// Frame Decoder Library
+
+//-----------------------------------------------------------------------------
+// Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: Linux host
+// Input:           telemetry.c byte stream from any lab
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include "frame_decoder.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// CRC-16/CCITT-FALSE (poly 0x1021), one entry per nibble, same table as telemetry.c
+static const uint16_t crcTable[16] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+static const uint8_t typeSize[9] = {0, 1, 1, 2, 2, 4, 4, 4, 8};
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+uint8_t getTelemetryTypeSize(uint8_t type)
+{
+    return type < sizeof(typeSize) ? typeSize[type] : 0;
+}
+
+uint16_t crc16Ccitt(const uint8_t data[], size_t length)
+{
+    uint16_t crc = 0xFFFF;
+    size_t i;
+    for (i = 0; i < length; i++)
+    {
+        crc = (crc << 4) ^ crcTable[(crc >> 12) ^ (data[i] >> 4)];
+        crc = (crc << 4) ^ crcTable[(crc >> 12) ^ (data[i] & 15)];
+    }
+    return crc;
+}
+
+FrameDecoder::FrameDecoder()
+{
+    stats = FrameDecoderStats();
+    reset();
+}
+
+void FrameDecoder::reset()
+{
+    length = 0;
+    remaining = 0;
+    pendingZero = false;
+    inFrame = false;
+    discarding = false;
+}
+
+// Returns true with record filled in when c completes a valid record
+bool FrameDecoder::feedByte(uint8_t c, TelemetryRecord &record)
+{
+    bool valid = false;
+
+    if (c == 0)
+    {
+        if (inFrame && !discarding)
+        {
+            if (remaining == 0)
+                valid = finishFrame(record);
+            else
+                stats.framingErrors++;
+        }
+        reset();
+        return valid;
+    }
+
+    inFrame = true;
+    if (discarding)
+        return false;
+
+    if (remaining == 0)
+    {
+        // Code byte: distance to the next replaced zero
+        if (pendingZero)
+            append(0);
+        remaining = c - 1;
+        pendingZero = c != 0xFF;
+    }
+    else
+    {
+        append(c);
+        remaining--;
+    }
+    return false;
+}
+
+// Frames longer than any valid record are dropped up to the next delimiter
+void FrameDecoder::append(uint8_t c)
+{
+    if (length == TELEMETRY_MAX_RECORD)
+    {
+        stats.framingErrors++;
+        discarding = true;
+        return;
+    }
+    frame[length++] = c;
+}
+
+bool FrameDecoder::finishFrame(TelemetryRecord &record)
+{
+    uint16_t payloadLength;
+    uint16_t crc;
+    uint8_t size;
+
+    if (length < TELEMETRY_HEADER_SIZE + 2)
+    {
+        stats.framingErrors++;
+        return false;
+    }
+
+    crc = frame[length - 2] | (frame[length - 1] << 8);
+    if (crc16Ccitt(frame, length - 2) != crc)
+    {
+        stats.crcErrors++;
+        return false;
+    }
+
+    payloadLength = length - TELEMETRY_HEADER_SIZE - 2;
+    size = getTelemetryTypeSize(frame[1]);
+    if (size == 0 || frame[1] == TELEMETRY_U64 || payloadLength % size != 0)
+    {
+        stats.typeErrors++;
+        return false;
+    }
+
+    record.channel = frame[0];
+    record.type = frame[1];
+    record.timestamp = frame[2] | (frame[3] << 8) | (frame[4] << 16) | ((uint32_t)frame[5] << 24);
+    record.payload = frame + TELEMETRY_HEADER_SIZE;
+    record.count = payloadLength / size;
+    stats.records++;
+    return true;
+}
@@ -0,0 +1,106 @@
+// Frame Decoder Library
+
+//-----------------------------------------------------------------------------
+// Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: Linux host
+// Input:           telemetry.c byte stream from any lab
+
+// Record layout (little endian, before COBS framing), see telemetry.h:
+//  byte 0       : channel id
+//  byte 1       : payload element type
+//  byte 2-5     : timestamp (us)
+//  byte 6-n     : payload
+//  byte n+1-n+2 : CRC-16/CCITT-FALSE of bytes 0-n
+// Each record is COBS encoded and followed by a 0x00 delimiter
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef FRAME_DECODER_H_
+#define FRAME_DECODER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define TELEMETRY_HEADER_SIZE 6
+#define TELEMETRY_MAX_PAYLOAD 240
+#define TELEMETRY_MAX_RECORD (TELEMETRY_HEADER_SIZE + TELEMETRY_MAX_PAYLOAD + 2)
+
+// Element types, matching TELEMETRY_TYPE in telemetry.h
+// U64 only appears in the host column files (extended timestamps)
+enum TelemetryType : uint8_t
+{
+    TELEMETRY_U8 = 1,
+    TELEMETRY_I8 = 2,
+    TELEMETRY_U16 = 3,
+    TELEMETRY_I16 = 4,
+    TELEMETRY_U32 = 5,
+    TELEMETRY_I32 = 6,
+    TELEMETRY_F32 = 7,
+    TELEMETRY_U64 = 8
+};
+
+uint8_t getTelemetryTypeSize(uint8_t type);
+
+// A decoded record, payload points into the decoder and is valid until the next byte is fed
+struct TelemetryRecord
+{
+    uint8_t channel;
+    uint8_t type;
+    uint32_t timestamp;
+    const uint8_t *payload;
+    uint16_t count;                                  // elements, not bytes
+};
+
+struct FrameDecoderStats
+{
+    uint64_t bytes;
+    uint64_t records;
+    uint64_t crcErrors;
+    uint64_t framingErrors;                          // bad COBS code, overflow or short record
+    uint64_t typeErrors;                             // unknown type or payload not a whole number of elements
+};
+
+// Streaming COBS decoder, fed one buffer at a time with no allocation
+class FrameDecoder
+{
+public:
+    FrameDecoder();
+
+    // Decode bytes and call onRecord for every record that passes the CRC
+    template <typename Callback>
+    void feed(const uint8_t data[], size_t length, Callback &&onRecord)
+    {
+        TelemetryRecord record;
+        size_t i;
+        for (i = 0; i < length; i++)
+        {
+            if (feedByte(data[i], record))
+                onRecord(record);
+        }
+        stats.bytes += length;
+    }
+
+    void reset();
+    const FrameDecoderStats &getStats() const { return stats; }
+
+private:
+    bool feedByte(uint8_t c, TelemetryRecord &record);
+    void append(uint8_t c);
+    bool finishFrame(TelemetryRecord &record);
+
+    uint8_t frame[TELEMETRY_MAX_RECORD];
+    uint16_t length;
+    uint8_t remaining;                               // data bytes left in the current COBS block
+    bool pendingZero;                                // the current block ends with a replaced zero
+    bool inFrame;                                    // bytes seen since the last delimiter
+    bool discarding;                                 // skip until the next delimiter
+    FrameDecoderStats stats;
+};
+
+uint16_t crc16Ccitt(const uint8_t data[], size_t length);
+
+#endif
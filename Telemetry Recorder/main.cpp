@@ -0,0 +1,296 @@
+/*
+ * Telemetry recorder
+ *
+ * record: read the binary telemetry stream of any lab from a serial device, pty or capture
+ *         file, check each record and append it to mapped column files per channel
+ * replay: feed a raw capture back through a new pty at the original line rate so the
+ *         recorder (or any other reader) can be exercised without hardware
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <string>
+#include "column_log.h"
+#include "frame_decoder.h"
+#include "serial_port.h"
+
+#define READ_BUFFER_SIZE 65536
+#define REPLAY_PERIOD_NS 10000000                    // 10 ms pacing slots
+#define DEFAULT_BAUD 115200
+
+static volatile sig_atomic_t running = 1;
+
+static void stopHandler(int)
+{
+    running = 0;
+}
+
+// No SA_RESTART, so a blocking read or write returns EINTR on ctrl-c
+static void installStopHandler(void)
+{
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stopHandler;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+}
+
+static double getSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static bool writeAll(int fd, const uint8_t data[], size_t length)
+{
+    ssize_t written;
+    while (length > 0 && running)
+    {
+        written = write(fd, data, length);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("write");
+            return false;
+        }
+        data += written;
+        length -= written;
+    }
+    return length == 0;
+}
+
+static void printStats(const FrameDecoderStats &decoder, const ColumnLogStats &log, double seconds)
+{
+    fprintf(stderr, "\r%llu bytes (%.0f B/s)  %llu records  %llu rows  crc %llu  framing %llu  type %llu  layout %llu  write %llu ",
+            (unsigned long long)decoder.bytes, seconds > 0 ? decoder.bytes / seconds : 0.0,
+            (unsigned long long)decoder.records, (unsigned long long)log.rows,
+            (unsigned long long)decoder.crcErrors, (unsigned long long)decoder.framingErrors,
+            (unsigned long long)decoder.typeErrors, (unsigned long long)log.layoutErrors,
+            (unsigned long long)log.writeErrors);
+}
+
+static int record(const std::string &device, const std::string &directory, uint32_t baudRate,
+                  bool keepCapture, bool selectBinary)
+{
+    static uint8_t buffer[READ_BUFFER_SIZE];
+    FrameDecoder decoder;
+    int capture = -1;
+    double start;
+    double lastPrint;
+    double now;
+    ssize_t n;
+    int fd;
+
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        fprintf(stderr, "%s: %s\n", directory.c_str(), strerror(errno));
+        return 1;
+    }
+    fd = openSerialPort(device, baudRate);
+    if (fd < 0)
+        return 1;
+    if (keepCapture)
+    {
+        capture = open((directory + "/capture.bin").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (capture < 0)
+        {
+            perror("capture.bin");
+            close(fd);
+            return 1;
+        }
+    }
+
+    // The labs start in text mode, the binary command switches them to binary records
+    if (selectBinary && isatty(fd))
+        writeAll(fd, reinterpret_cast<const uint8_t *>("binary\r"), 7);
+
+    ColumnLog log(directory);
+    installStopHandler();
+    start = getSeconds();
+    lastPrint = start;
+    while (running)
+    {
+        n = read(fd, buffer, sizeof(buffer));
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno != EIO)                        // EIO is a replay pty closing
+                perror("read");
+            break;
+        }
+        if (n == 0)
+            break;                                   // end of a capture file
+        if (capture >= 0 && !writeAll(capture, buffer, n))
+            break;
+        decoder.feed(buffer, n, [&log](const TelemetryRecord &r) { log.write(r); });
+
+        now = getSeconds();
+        if (now - lastPrint >= 1.0)
+        {
+            printStats(decoder.getStats(), log.getStats(), now - start);
+            lastPrint = now;
+        }
+    }
+
+    log.close();
+    printStats(decoder.getStats(), log.getStats(), getSeconds() - start);
+    fprintf(stderr, "\n");
+    if (capture >= 0)
+        close(capture);
+    close(fd);
+    return 0;
+}
+
+static int replay(const std::string &capturePath, uint32_t baudRate, bool loop)
+{
+    struct timespec next;
+    struct stat info;
+    std::string slavePath;
+    const uint8_t *data;
+    size_t chunk;
+    size_t offset;
+    size_t length;
+    void *address;
+    int queued;
+    int master;
+    int slave;
+    int fd;
+
+    fd = open(capturePath.c_str(), O_RDONLY);
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        fprintf(stderr, "%s: %s\n", capturePath.c_str(), strerror(errno));
+        return 1;
+    }
+    if (info.st_size == 0)
+    {
+        fprintf(stderr, "%s: empty capture\n", capturePath.c_str());
+        close(fd);
+        return 1;
+    }
+    address = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED)
+    {
+        perror("mmap");
+        return 1;
+    }
+    data = static_cast<const uint8_t *>(address);
+
+    master = openReplayPty(slavePath, slave);
+    if (master < 0)
+    {
+        munmap(address, info.st_size);
+        return 1;
+    }
+    printf("replaying %s on %s\n", capturePath.c_str(), slavePath.c_str());
+    fflush(stdout);
+
+    // 10 bits per byte on the wire, sent in 10 ms slots
+    chunk = baudRate != 0 ? baudRate / 10 / (1000000000 / REPLAY_PERIOD_NS) : READ_BUFFER_SIZE;
+    if (chunk == 0)
+        chunk = 1;
+
+    installStopHandler();
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    offset = 0;
+    while (running)
+    {
+        length = info.st_size - offset < chunk ? info.st_size - offset : chunk;
+        if (!writeAll(master, data + offset, length))
+            break;
+        offset += length;
+        if (offset == (size_t)info.st_size)
+        {
+            if (!loop)
+                break;
+            offset = 0;
+        }
+        if (baudRate != 0)
+        {
+            next.tv_nsec += REPLAY_PERIOD_NS;
+            if (next.tv_nsec >= 1000000000)
+            {
+                next.tv_nsec -= 1000000000;
+                next.tv_sec++;
+            }
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+        }
+    }
+
+    // Let the reader drain what is still queued in the pty before it goes away
+    while (running && ioctl(slave, FIONREAD, &queued) == 0 && queued > 0)
+        usleep(REPLAY_PERIOD_NS / 1000);
+    close(slave);
+    close(master);
+    munmap(address, info.st_size);
+    return 0;
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr,
+            "usage: %s record <device> <output directory> [-b baud] [-c] [-n]\n"
+            "         -b baud  tty speed (default %u)\n"
+            "         -c       keep the raw stream as <output directory>/capture.bin for replay\n"
+            "         -n       do not send the binary command to switch the board to binary records\n"
+            "       %s replay <capture> [-b baud] [-l]\n"
+            "         -b baud  pace at this line rate, 0 sends as fast as the reader takes it (default %u)\n"
+            "         -l       loop the capture until stopped\n",
+            program, DEFAULT_BAUD, program, DEFAULT_BAUD);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t baudRate = DEFAULT_BAUD;
+    bool keepCapture = false;
+    bool selectBinary = true;
+    bool loop = false;
+    std::string command;
+    int positional;
+    int i;
+
+    if (argc < 3)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    command = argv[1];
+    positional = command == "record" ? 2 : 1;
+
+    for (i = 2 + positional; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+            baudRate = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "-c") == 0)
+            keepCapture = true;
+        else if (strcmp(argv[i], "-n") == 0)
+            selectBinary = false;
+        else if (strcmp(argv[i], "-l") == 0)
+            loop = true;
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (command == "record" && argc >= 4)
+        return record(argv[2], argv[3], baudRate, keepCapture, selectBinary);
+    if (command == "replay")
+        return replay(argv[2], baudRate, loop);
+    usage(argv[0]);
+    return 2;
+}
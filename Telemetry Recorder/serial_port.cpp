@@ -0,0 +1,127 @@
+// Serial Port Library
+
+//-----------------------------------------------------------------------------
+// Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: Linux host
+// Device:          USB virtual COM port of the EK-TM4C123GXL or a pty
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "serial_port.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static const struct
+{
+    uint32_t rate;
+    speed_t speed;
+} speeds[] =
+{
+    {9600, B9600}, {19200, B19200}, {38400, B38400}, {57600, B57600},
+    {115200, B115200}, {230400, B230400}, {460800, B460800}, {500000, B500000},
+    {921600, B921600}, {1000000, B1000000}, {1500000, B1500000}, {2000000, B2000000},
+    {3000000, B3000000}, {4000000, B4000000}
+};
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+bool setSerialPortRaw(int fd, uint32_t baudRate)
+{
+    struct termios options;
+    size_t i;
+
+    if (tcgetattr(fd, &options) != 0)
+    {
+        perror("tcgetattr");
+        return false;
+    }
+    cfmakeraw(&options);
+    options.c_cflag |= CLOCAL | CREAD;
+    options.c_cc[VMIN] = 1;
+    options.c_cc[VTIME] = 0;
+
+    if (baudRate != 0)
+    {
+        for (i = 0; i < sizeof(speeds) / sizeof(speeds[0]); i++)
+        {
+            if (speeds[i].rate == baudRate)
+                break;
+        }
+        if (i == sizeof(speeds) / sizeof(speeds[0]))
+        {
+            fprintf(stderr, "unsupported baud rate %u\n", baudRate);
+            return false;
+        }
+        cfsetispeed(&options, speeds[i].speed);
+        cfsetospeed(&options, speeds[i].speed);
+    }
+
+    if (tcsetattr(fd, TCSANOW, &options) != 0)
+    {
+        perror("tcsetattr");
+        return false;
+    }
+    return true;
+}
+
+int openSerialPort(const std::string &path, uint32_t baudRate)
+{
+    int fd = open(path.c_str(), O_RDWR | O_NOCTTY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "%s: %s\n", path.c_str(), strerror(errno));
+        return -1;
+    }
+    if (isatty(fd) && !setSerialPortRaw(fd, baudRate))
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int openReplayPty(std::string &slavePath, int &slave)
+{
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    const char *name;
+
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+    {
+        perror("posix_openpt");
+        if (master >= 0)
+            close(master);
+        return -1;
+    }
+    name = ptsname(master);
+    if (name == nullptr)
+    {
+        perror("ptsname");
+        close(master);
+        return -1;
+    }
+    slavePath = name;
+
+    // Raw slave so replayed bytes reach the reader unchanged (no echo, no newline mapping)
+    slave = openSerialPort(slavePath, 0);
+    if (slave < 0)
+    {
+        close(master);
+        return -1;
+    }
+    return master;
+}
@@ -0,0 +1,34 @@
+// Serial Port Library
+
+//-----------------------------------------------------------------------------
+// Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: Linux host
+// Device:          USB virtual COM port of the EK-TM4C123GXL or a pty
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef SERIAL_PORT_H_
+#define SERIAL_PORT_H_
+
+#include <stdint.h>
+#include <string>
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Open a tty raw 8N1, baud 0 leaves the speed alone (ptys ignore it anyway)
+int openSerialPort(const std::string &path, uint32_t baudRate);
+
+// Set an already open tty raw 8N1
+bool setSerialPortRaw(int fd, uint32_t baudRate);
+
+// Create a pty for replay, returns the master and the slave path
+// The slave is also opened and returned so the pty stays up between readers
+int openReplayPty(std::string &slavePath, int &slave);
+
+#endif
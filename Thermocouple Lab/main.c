@@ -1,7 +1,6 @@
 /*
  *  Antonio Buentello
  */
-#include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include "wait.h"
@@ -10,6 +9,9 @@
 #include "gpio.h"
 #include "clock.h"
 #include "i2c0.h"
+#include "format.h"
+#include "telemetry.h"
+#include "command.h"
 
 /*
  * Device: Registers
@@ -124,7 +126,6 @@ float int16ToScaledVoltsThermocouple(int16_t value){
     return voltage * 1000.0;
 }
 float tmpMeasure(void){
-    char str[10];
     int16_t raw = 0;
     float scaled = 0;
     float scaledMV = 0;
@@ -143,28 +144,28 @@ float tmpMeasure(void){
 
     // 100 : AINP = AIN0 and AINN = GND
 
-    putsUart0("RAW TMP36: ");
-    sprintf(str, "%d", raw);
-    putsUart0(str);
-    putsUart0("\n");
-
-    putsUart0("Scaled TMP36 (mV): ");
     scaledMV = int16ToScaledVoltsTMP36(raw);
-    sprintf(str, "%f", scaledMV);
-    putsUart0(str);
-    putsUart0("\n");
-
-    putsUart0("TMP36 Temperature (C): ");
     scaled = int16ToC(raw);
-    sprintf(str, "%f", scaled);
-    putsUart0(str);
-    putsUart0("\n");
+
+    if (getTelemetryMode() == TELEMETRY_TEXT){
+        putsUart0("RAW TMP36: ");
+        putIntUart0(raw, 0);
+        putsUart0("\n");
+
+        putsUart0("Scaled TMP36 (mV): ");
+        putFixedUart0(scaledMV * 1000000, 6);
+        putsUart0("\n");
+
+        putsUart0("TMP36 Temperature (C): ");
+        putFixedUart0(scaled * 1000000, 6);
+        putsUart0("\n");
+    }
+    sendTelemetry(TELEMETRY_TMP36_RAW, TELEMETRY_I16, &raw, 1);
 
     return scaledMV;
 
 }
 float thermoMeasure(void){
-    char str[10];
     int16_t raw2 = 0;
     float scaled2 = 0;
     uint8_t rawData2[2] = {0,0};
@@ -181,16 +182,18 @@ float thermoMeasure(void){
 
     // 010 : AINP = AIN1 and AINN = AIN3
 
-    putsUart0("RAW Thermo-couple: ");
-    sprintf(str, "%d", raw2);
-    putsUart0(str);
-    putsUart0("\n");
-
-    putsUart0("Scaled Thermo-couple (mV): ");
     scaled2 = int16ToScaledVoltsThermocouple(raw2);
-    sprintf(str, "%f", scaled2);
-    putsUart0(str);
-    putsUart0("\n");
+
+    if (getTelemetryMode() == TELEMETRY_TEXT){
+        putsUart0("RAW Thermo-couple: ");
+        putIntUart0(raw2, 0);
+        putsUart0("\n");
+
+        putsUart0("Scaled Thermo-couple (mV): ");
+        putFixedUart0(scaled2 * 1000000, 6);
+        putsUart0("\n");
+    }
+    sendTelemetry(TELEMETRY_THERMOCOUPLE_RAW, TELEMETRY_I16, &raw2, 1);
 
     return scaled2;
 
@@ -223,13 +226,40 @@ float interpolate(bool isNegative, bool isPositive, int32_t index, float summedV
         return y;
     }
 }
+// Console commands, dispatched through the hashed table in command.c
+void binaryCommand(const COMMAND_ARGS *args){
+    setTelemetryMode(TELEMETRY_BINARY);
+}
+
+void textCommand(const COMMAND_ARGS *args){
+    setTelemetryMode(TELEMETRY_TEXT);
+}
+
+const COMMAND commands[] =
+{
+    {"binary", 0, "", binaryCommand},
+    {"text", 0, "", textCommand}
+};
+
+void processCommand(USER_DATA *data){
+    COMMAND_STATUS status = runCommand(data);
+    if (getTelemetryMode() == TELEMETRY_TEXT){
+        putCommandStatusUart0(status);
+    }
+}
+
 int main(void){
     initHw();
     initUart0();
     setUart0BaudRate(115200, 40e6);
     initI2c0();
-    char str[10];
+    initTelemetry();
+    startUart0LineInput();
+    if (!initCommands(commands, sizeof(commands) / sizeof(commands[0]))){
+        putsUart0("Command table init failed\n");
+    }
 
+    USER_DATA data;
     float coldJunctionVoltage;
     float thermocoupleVoltage;
     float summedVoltage;
@@ -243,13 +273,17 @@ int main(void){
     while(1){
         i = 0;
 
+        if (getUart0Line(&data)){
+            processCommand(&data);
+        }
         coldJunctionVoltage = tmpMeasure();
         thermocoupleVoltage = thermoMeasure();
         summedVoltage = coldJunctionVoltage + thermocoupleVoltage;
-        putsUart0("Summed Voltage: ");
-        sprintf(str, "%f", summedVoltage);
-        putsUart0(str);
-        putsUart0("\n");
+        if (getTelemetryMode() == TELEMETRY_TEXT){
+            putsUart0("Summed Voltage: ");
+            putFixedUart0(summedVoltage * 1000000, 6);
+            putsUart0("\n");
+        }
 
         if (summedVoltage < 0.0){
             isNegative = true;
@@ -270,15 +304,16 @@ int main(void){
 
             temperature = interpolate(isNegative, isPositive, i, summedVoltage);
         }
-        putsUart0("i = ");
-        sprintf(str, "%d", i);
-        putsUart0(str);
-        putsUart0("\n");
-
-        putsUart0("Actual Temperature (C): ");
-        sprintf(str, "%f", temperature);
-        putsUart0(str);
-        putsUart0("\n\n");
+        if (getTelemetryMode() == TELEMETRY_TEXT){
+            putsUart0("i = ");
+            putIntUart0(i, 0);
+            putsUart0("\n");
+
+            putsUart0("Actual Temperature (C): ");
+            putFixedUart0(temperature * 1000000, 6);
+            putsUart0("\n\n");
+        }
+        sendTelemetry(TELEMETRY_TEMPERATURE, TELEMETRY_F32, &temperature, 1);
 
 
         waitMicrosecond(500000);
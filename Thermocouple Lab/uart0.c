@@ -31,10 +31,216 @@
 // Global variables
 //-----------------------------------------------------------------------------
 
+// Transmit queue, written by putcUart0 and drained by uart0Isr
+static volatile char txBuffer[UART0_TX_BUFFER_SIZE];
+static volatile uint16_t txWriteIndex = 0;
+static volatile uint16_t txReadIndex = 0;
+static UART0_TX_POLICY txPolicy = UART0_TX_BLOCK;
+static uint32_t txQueuedCount = 0;
+static uint32_t txDroppedCount = 0;
+
+// Command line, edited by uart0Isr once line input is started and handed over by rxLineReady
+static char rxLine[MAX_CHARS + 1];
+static uint8_t rxCount = 0;
+static volatile bool rxLineReady = false;
+static uint32_t rxDroppedCount = 0;
+
 //-----------------------------------------------------------------------------
 // Subroutines
 //-----------------------------------------------------------------------------
 
+/*
+ * reentrant atoi function
+ * (*p) - '0' is subtracting value of char '0' from char pointed to be p
+ * this turns it into a number
+ */
+int r_atoi(char *ptr) {
+
+    int value = 0;
+    bool negFlag = false;
+
+    if (*ptr && *ptr == '-')        // checks for negative numbers, set the flag if so
+    {
+        negFlag = true;
+        ptr++;
+    }
+
+    while (*ptr) {
+
+        value = (value * 10) + (*ptr) - '0';
+        ptr++;
+     }
+
+    if (negFlag)                    // makes the value negative
+    {
+        value *= -1;
+    }
+    return value;
+}
+
+/*
+   Function to receive chars from the UI, processing special chars such as backspace
+   and writing the resultant string into the buffer
+   Backspace = 8, DEL = 127
+*/
+void getsUart0 (USER_DATA *data)
+{
+    char c;
+    uint8_t count = 0;
+
+    while (true)
+    {
+        c = getcUart0();                                 // get a char and put in buffer
+        if ((c == 8 || c == 127) && (count > 0))         // remove backspace char and check if backspace is the first char
+        {
+            count--;
+        }
+        else if (c == 13 || c == 10)                     // check if <enter key> was pressed
+        {
+            data->buffer[count] = '\0';
+            break;
+        }
+        else if (c >= 32)                                // check if <space> or any printable char is pressed
+        {
+            data->buffer[count++] = c;
+
+            if (count == MAX_CHARS)                      // program will exit if max char are input
+            {
+                data->buffer[count] = '\0';
+                break;
+            }
+        }
+    }
+}
+
+/*
+ * LETTER A : 65 , Z : 90 , a : 97 , z : 122
+ * NUMBER 0 : 48 , 9 : 57, includes (-)
+ * Everything else is a delimiter
+ */
+void parseFields (USER_DATA *data)
+{
+    char previous = 'd';
+
+    data->fieldCount = 0;
+
+    uint8_t count = 0;
+    uint8_t index = 0;
+
+    while (data->buffer[count] != '\0')
+    {
+        char c = data->buffer[count];
+
+        // exit the loop if we already have our max fields
+        if ( data->fieldCount == MAX_FIELDS )
+        {
+            break;
+        }
+
+        // check if it's an alpha
+        //&& ( (previous == 'd') || (previous == 'n') )
+        else if ( ( (c >= 65 && c <= 90) || (c >= 97 && c <= 122) ) )
+        {
+            if (previous == 'a')
+            {
+                count++;
+                continue;
+            }
+            data->fieldCount++;
+            data->fieldType[index] = 'a';
+            data->fieldPosition[index++] = count;
+            previous = 'a';
+        }
+
+        //check if its numeric
+        // || (previous == 'a') && ( (previous == 'd') )
+        else if ( (c >= 48 && c <= 57) || (c == '-') )
+        {
+            if (previous == 'n')
+            {
+                count++;
+                continue;
+            }
+            data->fieldCount++;
+            data->fieldType[index] = 'n';
+            data->fieldPosition[index++] = count;
+            previous = 'n';
+        }
+
+        // otherwise, it's a delimiter
+        else
+        {
+            previous = 'd';
+            data->buffer[count] = '\0';
+        }
+
+        count++;
+    }
+}
+
+
+/*
+ *  Returns the value of a field requested if the field
+ *  is in range or NULL otherwise.
+ *  returns the address of
+ */
+char *getFieldString (USER_DATA *data, uint8_t fieldNumber)
+{
+    if (fieldNumber <= data->fieldCount)
+    {
+        return &data->buffer[data->fieldPosition[fieldNumber]];
+    }
+    else
+    {
+        return '\0';
+    }
+}
+
+/*
+ * Function to return the integer value of the field if the
+ * field number is in range and the field type is numeric or 0 otherwise.
+ */
+int32_t getFieldInteger (USER_DATA *data, uint8_t fieldNumber)
+{
+    if ( (fieldNumber <= data->fieldCount) && (data->fieldType[fieldNumber] == 'n') )
+    {
+        return r_atoi( &data->buffer[ data->fieldPosition[ fieldNumber ] ] );
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+int strCmp (const char *str1, const char *str2)
+{
+    while ( *str1 && ( (*str1 == *str2)  || (*str1+32 == *str2) || (*str1-32 == *str2) ))
+    {
+        str1++;
+        str2++;
+    }
+    return *(const unsigned char*)str1 - *(const unsigned char*)str2;
+}
+
+ /*
+  * Returns true if the command matches the first field
+  * and the number of arguments (excluding the command field) is greater
+  * than or equal to the requested number of minimum arguments.
+  */
+bool isCommand (USER_DATA *data, const char strCommand[], uint8_t minArguements)
+{
+    uint8_t fieldNums = data->fieldCount;
+
+    if (fieldNums-1 >= minArguements && ( strCmp(data->buffer, strCommand) == 0))
+    {
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
 // Initialize UART0
 void initUart0()
 {
@@ -59,6 +265,16 @@ void initUart0()
     UART0_LCRH_R = UART_LCRH_WLEN_8 | UART_LCRH_FEN;    // configure for 8N1 w/ 16-level FIFO
     UART0_CTL_R = UART_CTL_TXE | UART_CTL_RXE | UART_CTL_UARTEN;
                                                         // enable TX, RX, and module
+
+    // Configure transmit queue and interrupt
+    txWriteIndex = txReadIndex = 0;
+    txQueuedCount = txDroppedCount = 0;
+    txPolicy = UART0_TX_BLOCK;
+    rxCount = 0;
+    rxLineReady = false;
+    UART0_IFLS_R = UART_IFLS_RX1_8 | UART_IFLS_TX1_8;   // interrupt when rx fifo fills or tx fifo drains to 1/8
+    UART0_IM_R = 0;                                     // tx interrupt is unmasked only while data is queued
+    NVIC_EN0_R = 1 << (INT_UART0-16);                   // turn-on interrupt 21 (UART0)
 }
 
 // Set baud rate as function of instruction cycle frequency
@@ -75,14 +291,52 @@ void setUart0BaudRate(uint32_t baudRate, uint32_t fcyc)
                                                         // turn-on UART0
 }
 
-// Blocking function that writes a serial character when the UART buffer is not full
+// Moves queued characters into the tx fifo until the queue is empty or the fifo is full
+static void fillUart0TxFifo()
+{
+    while ((txReadIndex != txWriteIndex) && !(UART0_FR_R & UART_FR_TXFF))
+    {
+        UART0_DR_R = txBuffer[txReadIndex];
+        txReadIndex = (txReadIndex + 1) & (UART0_TX_BUFFER_SIZE - 1);
+    }
+}
+
+// Non-blocking function that queues a serial character for the UART0 interrupt to send
+// When the queue is full, the character is handled according to the tx policy
 void putcUart0(char c)
 {
-    while (UART0_FR_R & UART_FR_TXFF);               // wait if uart0 tx fifo full
-    UART0_DR_R = c;                                  // write character to fifo
+    uint16_t next;
+
+    UART0_IM_R &= ~UART_IM_TXIM;                     // hold off uart0Isr while the queue is modified
+    next = (txWriteIndex + 1) & (UART0_TX_BUFFER_SIZE - 1);
+    if (next == txReadIndex)
+    {
+        if (txPolicy == UART0_TX_BLOCK)
+        {
+            while (next == txReadIndex)
+                fillUart0TxFifo();                   // drain by polling, so this is safe inside an isr
+        }
+        else if (txPolicy == UART0_TX_DROP_OLDEST)
+        {
+            txReadIndex = (txReadIndex + 1) & (UART0_TX_BUFFER_SIZE - 1);
+            txDroppedCount++;
+        }
+        else
+        {
+            txDroppedCount++;
+            UART0_IM_R |= UART_IM_TXIM;
+            return;
+        }
+    }
+    txBuffer[txWriteIndex] = c;
+    txWriteIndex = next;
+    txQueuedCount++;
+    fillUart0TxFifo();                               // start transmission if the fifo has room
+    if (txReadIndex != txWriteIndex)
+        UART0_IM_R |= UART_IM_TXIM;                  // let uart0Isr send the rest as the fifo drains
 }
 
-// Blocking function that writes a string when the UART buffer is not full
+// Non-blocking function that queues a string for the UART0 interrupt to send
 void putsUart0(char* str)
 {
     uint8_t i = 0;
@@ -91,6 +345,7 @@ void putsUart0(char* str)
 }
 
 // Blocking function that returns with serial data once the buffer is not empty
+// Received characters go to the line editor instead once startUart0LineInput is called
 char getcUart0()
 {
     while (UART0_FR_R & UART_FR_RXFE);               // wait if uart0 rx fifo empty
@@ -102,3 +357,117 @@ bool kbhitUart0()
 {
     return !(UART0_FR_R & UART_FR_RXFE);
 }
+
+// Selects how putcUart0 handles a full transmit queue
+void setUart0TxPolicy(UART0_TX_POLICY policy)
+{
+    txPolicy = policy;
+}
+
+// Returns the number of characters accepted into the transmit queue
+uint32_t getUart0TxQueuedCount()
+{
+    return txQueuedCount;
+}
+
+// Returns the number of characters discarded because the transmit queue was full
+uint32_t getUart0TxDroppedCount()
+{
+    return txDroppedCount;
+}
+
+// Blocking function that returns once all queued characters have left the UART
+void flushUart0()
+{
+    while (txReadIndex != txWriteIndex);             // wait for uart0Isr to empty the queue
+    while (UART0_FR_R & UART_FR_BUSY);               // wait for the last character to shift out
+}
+
+// Line editor run by uart0Isr for each received character, same keys as getsUart0
+// Characters arriving before the main loop takes the previous line are dropped
+static void editUart0Line(char c)
+{
+    if (rxLineReady)
+    {
+        rxDroppedCount++;
+    }
+    else if (c == 8 || c == 127)                     // backspace or delete
+    {
+        if (rxCount > 0)
+            rxCount--;
+    }
+    else if (c == 13 || c == 10)                     // enter, empty lines (e.g. the lf of cr-lf) are ignored
+    {
+        if (rxCount > 0)
+        {
+            rxLine[rxCount] = '\0';
+            rxLineReady = true;
+        }
+    }
+    else if (c >= 32)                                // space or any printable char
+    {
+        rxLine[rxCount++] = c;
+        if (rxCount == MAX_CHARS)
+        {
+            rxLine[rxCount] = '\0';
+            rxLineReady = true;
+        }
+    }
+}
+
+// Assemble command lines in the background from the rx interrupt
+void startUart0LineInput()
+{
+    rxCount = 0;
+    rxLineReady = false;
+    UART0_ICR_R = UART_ICR_RXIC | UART_ICR_RTIC;
+    UART0_IM_R |= UART_IM_RXIM | UART_IM_RTIM;       // rx timeout delivers characters that do not fill the fifo
+}
+
+// Returns true once enter has been pressed on a line that has not been taken yet
+bool isUart0LineReady()
+{
+    return rxLineReady;
+}
+
+// Non-blocking replacement for getsUart0 and parseFields
+// Returns false if no line is ready, otherwise copies and parses it and starts the next one
+bool getUart0Line(USER_DATA *data)
+{
+    uint8_t i = 0;
+
+    if (!rxLineReady)
+        return false;
+    do
+    {
+        data->buffer[i] = rxLine[i];
+    } while (rxLine[i++] != '\0');
+    rxCount = 0;
+    rxLineReady = false;                             // hand the line back to uart0Isr
+    parseFields(data);
+    return true;
+}
+
+// Returns the number of characters received while a completed line was waiting
+uint32_t getUart0RxDroppedCount()
+{
+    return rxDroppedCount;
+}
+
+// UART0 interrupt service routine feeding the line editor and refilling the tx fifo
+void uart0Isr()
+{
+    if (UART0_MIS_R & (UART_MIS_RXMIS | UART_MIS_RTMIS))
+    {
+        UART0_ICR_R = UART_ICR_RXIC | UART_ICR_RTIC; // clear interrupt flags
+        while (!(UART0_FR_R & UART_FR_RXFE))
+            editUart0Line(UART0_DR_R & 0xFF);
+    }
+    if (UART0_MIS_R & UART_MIS_TXMIS)
+    {
+        UART0_ICR_R = UART_ICR_TXIC;                 // clear interrupt flag
+        fillUart0TxFifo();
+        if (txReadIndex == txWriteIndex)
+            UART0_IM_R &= ~UART_IM_TXIM;             // nothing left to send
+    }
+}